@@ -0,0 +1,373 @@
+//microbenchmarks of the containers and algorithms, with std::forward_list, std::list and std::vector as baselines.
+//usage: benchmark [--min-size=N] [--max-size=N] [--warmup=N] [--reps=N] [--filter=container/op/distribution]
+//the results are written to stdout as a JSON array, the progress is written to stderr.
+//the crossovers of polynormial_function::multiply(): --min-size=10 --max-size=1000000 --filter=polynormial_function/multiply
+
+#include <list>
+#include <span>
+#include <cstdio>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <optional>
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+#include <forward_list>
+#include <linked_list.hpp>
+#include <double_list.hpp>
+#include <polynormial_function.hpp>
+
+namespace bench {
+
+using rais::study::linked_list;
+using rais::study::double_list;
+using rais::study::polyfunc;
+using rais::study::polyitem;
+namespace multiply_policy = rais::study::multiply_policy;
+
+using clock = std::chrono::steady_clock;
+
+//keeps the results of the timed bodies alive
+volatile long long sink = 0;
+
+struct options {
+	size_t min_size = 1000;
+	size_t max_size = 1'0000'0000;
+	size_t warmup = 1;
+	size_t repetitions = 7;
+	std::string filter;  //only runs the benchmarks whose name contains it
+};
+
+enum class distribution {random, sorted, reversed, duplicates};
+constexpr distribution distributions[] = {distribution::random, distribution::sorted, distribution::reversed, distribution::duplicates};
+
+const char* name_of(distribution dist) noexcept{
+	switch(dist) {
+		case distribution::random:     return "random";
+		case distribution::sorted:     return "sorted";
+		case distribution::reversed:   return "reversed";
+		case distribution::duplicates: return "duplicates";
+	}
+	return "";
+}
+
+std::vector<int> make_input(distribution dist, size_t n, unsigned seed = 42) {
+	std::minstd_rand randint{seed};
+	std::uniform_int_distribution<int> mask;
+	std::vector<int> values(n);
+	for(size_t i = 0; i < n; i++) {
+		switch(dist) {
+			case distribution::random:     values[i] = mask(randint); break;
+			case distribution::sorted:     values[i] = static_cast<int>(i); break;
+			case distribution::reversed:   values[i] = static_cast<int>(n - i); break;
+			case distribution::duplicates: values[i] = mask(randint) % 16; break;
+		}
+	}
+	return values;
+}
+
+std::vector<size_t> random_indices(size_t k, size_t n, unsigned seed = 7) {
+	std::minstd_rand randint{seed};
+	std::vector<size_t> indices(k);
+	for(auto& i: indices) i = randint() % n;
+	return indices;
+}
+
+size_t positional_ops(size_t n) noexcept{
+	//the number of insert/erase/operator[] calls per repetition, so that an O(n) call costs about 1e7 steps in total
+	size_t k = 1000'0000 / n;
+	return k < 1 ? 1 : k > 1000 ? 1000 : k;
+}
+
+class runner {
+	options opt;
+	bool first = true;
+
+public:
+	explicit runner(options opt): opt(std::move(opt)) {std::printf("[\n"); }
+	~runner() {std::printf("\n]\n"); }
+
+	const options& get_options() const noexcept{return opt; }
+
+	//setup() returns the untimed state of a repetition, body(state) is timed, the state is destroyed untimed.
+	template <typename SetupT, typename BodyT>
+	void run(std::string_view container, std::string_view op, distribution dist, size_t n, size_t ops, SetupT&& setup, BodyT&& body) {
+		std::string name = std::string(container) + '/' + std::string(op) + '/' + name_of(dist);
+		if(!opt.filter.empty() and name.find(opt.filter) == std::string::npos) return;
+		std::cerr << name << " n=" << n << '\n';
+
+		std::vector<double> samples; //ns
+		samples.reserve(opt.repetitions);
+		for(size_t i = 0; i < opt.warmup + opt.repetitions; i++) {
+			auto state = setup();
+			auto start = clock::now();
+			body(state);
+			auto end = clock::now();
+			if(i >= opt.warmup) samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+		}
+		std::sort(samples.begin(), samples.end());
+		auto percentile = [&samples](double p) {return samples[static_cast<size_t>(p * (samples.size() - 1) + 0.5)]; };
+		double mean = 0;
+		for(double s: samples) mean += s;
+		mean /= samples.size();
+
+		std::printf("%s  {\"container\": \"%.*s\", \"op\": \"%.*s\", \"distribution\": \"%s\", \"size\": %zu, \"ops\": %zu, "
+		            "\"warmup\": %zu, \"repetitions\": %zu, \"unit\": \"ns\", "
+		            "\"min\": %.0f, \"p10\": %.0f, \"median\": %.0f, \"p90\": %.0f, \"max\": %.0f, \"mean\": %.0f, \"median_per_op\": %.3f}",
+		            first ? "" : ",\n",
+		            static_cast<int>(container.size()), container.data(), static_cast<int>(op.size()), op.data(), name_of(dist), n, ops,
+		            opt.warmup, opt.repetitions,
+		            samples.front(), percentile(0.1), percentile(0.5), percentile(0.9), samples.back(), mean, percentile(0.5) / ops);
+		std::fflush(stdout);
+		first = false;
+	}
+};
+
+
+//uniform operations over the benchmarked containers
+
+template <typename ListT>
+concept has_push_back = requires(ListT c) {c.push(0); } or requires(ListT c) {c.push_back(0); };
+template <typename ListT>
+concept has_push_front = requires(ListT c) {c.unshift(0); } or requires(ListT c) {c.push_front(0); };
+template <typename ListT>
+concept has_sort = requires(ListT c) {c.sort(); } or std::same_as<ListT, std::vector<int>>;
+template <typename ListT>
+concept has_merge = requires(ListT c) {c.merge(std::move(c)); } or std::same_as<ListT, std::vector<int>>;
+
+template <typename ListT>
+void push_back(ListT& c, int val) {
+	if constexpr(requires {c.push(val); }) c.push(val);
+	else c.push_back(val);
+}
+
+template <typename ListT>
+void push_front(ListT& c, int val) {
+	if constexpr(requires {c.unshift(val); }) c.unshift(val);
+	else c.push_front(val);
+}
+
+template <typename ListT>
+ListT build(std::span<const int> values) {
+	ListT c;
+	if constexpr(has_push_back<ListT>) for(int val: values) push_back(c, val);
+	else c.assign(values.begin(), values.end());
+	return c;
+}
+
+template <typename ListT>
+void insert_at(ListT& c, size_t index, int val) {
+	if constexpr(requires {c.insert(index, val); }) c.insert(index, val);
+	else if constexpr(requires {c.insert_after(c.before_begin(), val); }) c.insert_after(std::next(c.before_begin(), index), val);
+	else c.insert(std::next(c.begin(), index), val);
+}
+
+template <typename ListT>
+void erase_at(ListT& c, size_t index) {
+	if constexpr(requires {c.erase(index); }) c.erase(index);
+	else if constexpr(requires {c.erase_after(c.before_begin()); }) c.erase_after(std::next(c.before_begin(), index));
+	else c.erase(std::next(c.begin(), index));
+}
+
+template <typename ListT>
+int at(ListT& c, size_t index) {
+	if constexpr(requires {c[index]; }) return c[index];
+	else return *std::next(c.begin(), index);
+}
+
+template <typename ListT>
+void reverse(ListT& c) {
+	if constexpr(requires {c.reverse(); }) c.reverse();
+	else std::reverse(c.begin(), c.end());
+}
+
+template <typename ListT>
+void sort(ListT& c) {
+	if constexpr(requires {c.sort(); }) c.sort();
+	else std::sort(c.begin(), c.end());
+}
+
+template <typename ListT>
+void merge(ListT& a, ListT& b) {
+	if constexpr(requires {a.merge(std::move(b)); }) a.merge(std::move(b));
+	else {
+		size_t mid = a.size();
+		a.insert(a.end(), b.begin(), b.end());
+		std::inplace_merge(a.begin(), a.begin() + mid, a.end());
+	}
+}
+
+
+template <typename ListT>
+void bench_container(runner& r, std::string_view name, distribution dist, size_t n) {
+	const std::vector<int> values = make_input(dist, n);
+	const size_t k = positional_ops(n) < n ? positional_ops(n) : n;
+	const std::vector<size_t> indices = random_indices(k, n);
+	auto filled = [&values] {return build<ListT>(values); };
+
+	if constexpr(has_push_back<ListT>) {
+		r.run(name, "push", dist, n, n, [] {return ListT{}; }, [&values](ListT& c) {
+			for(int val: values) push_back(c, val);
+		});
+	}
+	if constexpr(has_push_front<ListT>) {
+		r.run(name, "unshift", dist, n, n, [] {return ListT{}; }, [&values](ListT& c) {
+			for(int val: values) push_front(c, val);
+		});
+	}
+	r.run(name, "insert", dist, n, k, filled, [&indices, n](ListT& c) {
+		for(size_t i = 0; i < indices.size(); i++) insert_at(c, indices[i] % (n + i + 1), static_cast<int>(i));
+	});
+	r.run(name, "erase", dist, n, k, filled, [&indices, n](ListT& c) {
+		for(size_t i = 0; i < indices.size(); i++) erase_at(c, indices[i] % (n - i));
+	});
+	r.run(name, "index", dist, n, k, filled, [&indices](ListT& c) {
+		long long sum = 0;
+		for(size_t i: indices) sum += at(c, i);
+		sink = sum;
+	});
+	r.run(name, "iterate", dist, n, n, filled, [](ListT& c) {
+		long long sum = 0;
+		for(int val: c) sum += val;
+		sink = sum;
+	});
+	r.run(name, "reverse", dist, n, n, filled, [](ListT& c) {reverse(c); });
+	if constexpr(has_merge<ListT>) {
+		r.run(name, "merge", dist, n, n, [&values] {
+			std::vector<int> a(values.begin(), values.begin() + values.size() / 2),
+			                 b(values.begin() + values.size() / 2, values.end());
+			std::sort(a.begin(), a.end());
+			std::sort(b.begin(), b.end());
+			return std::pair{build<ListT>(a), build<ListT>(b)};
+		}, [](std::pair<ListT, ListT>& lists) {merge(lists.first, lists.second); });
+	}
+	if constexpr(has_sort<ListT>) {
+		r.run(name, "sort", dist, n, n, filled, [](ListT& c) {sort(c); });
+	}
+	if constexpr(requires(ListT c) {c.merge_sort(); }) {
+		r.run(name, "merge_sort", dist, n, n, filled, [](ListT& c) {c.merge_sort(); });
+	}
+	if constexpr(requires(ListT c) {c.quick_sort(); }) {
+		r.run(name, "quick_sort", dist, n, n, filled, [](ListT& c) {c.quick_sort(); });
+	}
+}
+
+linked_list<polyitem> make_terms(distribution dist, size_t n, unsigned seed) {
+	//the exponents follow the distribution, random exponents are in [0, 4n)
+	std::vector<int> values = make_input(dist, n, seed);
+	linked_list<polyitem> terms;
+	for(size_t i = 0; i < n; i++) {
+		size_t exponent = dist == distribution::random ? static_cast<size_t>(values[i]) % (4 * n) : static_cast<size_t>(values[i]);
+		terms.push(polyitem{1.0 + static_cast<double>(i % 7), exponent});
+	}
+	return terms;
+}
+
+void bench_polynormial(runner& r, distribution dist, size_t n) {
+	struct state {
+		polyfunc f1, f2;
+		std::optional<polyfunc> sum;
+	};
+	r.run("polynormial_function", "operator+", dist, n, n, [dist, n] {
+		return state{polyfunc(make_terms(dist, n, 1)), polyfunc(make_terms(dist, n, 2)), std::nullopt};
+	}, [](state& s) {s.sum.emplace(s.f1 + s.f2); });
+}
+
+void bench_polynormial_eval(runner& r, distribution dist, size_t n) {
+	//about 1e7 term evaluations per repetition
+	size_t points = std::clamp<size_t>(1000'0000 / n, 64, 1 << 20);
+	std::vector<double> xs(points);
+	for(size_t i = 0; i < points; i++) xs[i] = static_cast<double>(i) / static_cast<double>(points);
+	auto setup = [dist, n] {return polyfunc(make_terms(dist, n, 1)); };
+	r.run("polynormial_function", "eval", dist, n, points, setup, [&xs](polyfunc& f) {
+		double sum = 0;
+		for(double x: xs) sum += f.eval(x);
+		sink = static_cast<long long>(sum);
+	});
+	r.run("polynormial_function", "eval_many", dist, n, points, setup, [&xs](polyfunc& f) {
+		std::vector<double> out(xs.size());
+		f.eval_many(xs, out);
+		sink = static_cast<long long>(out.back());
+	});
+}
+
+void bench_polynormial_stream(runner& r, distribution dist, size_t n) {
+	//the terms arrive one by one, or in batches of 256
+	auto setup = [dist, n] {
+		std::vector<polyitem> items;
+		for(const polyitem& item: make_terms(dist, n, 1)) items.push_back(item);
+		return items;
+	};
+	r.run("polynormial_function", "add_term", dist, n, n, setup, [](std::vector<polyitem>& items) {
+		polyfunc f;
+		for(const polyitem& item: items) f.add_term(item.a, item.n);
+		sink = static_cast<long long>(f.size());
+	});
+	r.run("polynormial_function", "add_terms", dist, n, n, setup, [](std::vector<polyitem>& items) {
+		constexpr size_t batch = 256;
+		polyfunc f;
+		for(size_t i = 0; i < items.size(); i += batch) f.add_terms(std::span(items).subspan(i, std::min(batch, items.size() - i)));
+		sink = static_cast<long long>(f.size());
+	});
+}
+
+void bench_polynormial_multiply(runner& r, distribution dist, size_t n) {
+	//sorted exponents make dense operands, random ones make sparse operands,
+	//the O(n^2) algorithms are skipped when they take more than about 1e8 steps
+	if(n > 100'0000 or (dist != distribution::sorted and dist != distribution::random)) return;
+	if(dist == distribution::random and n > 1'0000) return;
+	auto setup = [dist, n] {return std::pair{polyfunc(make_terms(dist, n, 1)), polyfunc(make_terms(dist, n, 2))}; };
+	auto product = [](auto policy) {
+		return [policy](std::pair<polyfunc, polyfunc>& s) {sink = static_cast<long long>(polyfunc::multiply(s.first, s.second, policy).size()); };
+	};
+	r.run("polynormial_function", "multiply/automatic", dist, n, n, setup, product(multiply_policy::automatic));
+	if(n <= 1'0000) {
+		r.run("polynormial_function", "multiply/sparse", dist, n, n, setup, product(multiply_policy::sparse));
+		r.run("polynormial_function", "multiply/schoolbook", dist, n, n, setup, product(multiply_policy::schoolbook));
+	}
+	if(n <= 10'0000) r.run("polynormial_function", "multiply/karatsuba", dist, n, n, setup, product(multiply_policy::karatsuba));
+	r.run("polynormial_function", "multiply/fft", dist, n, n, setup, product(multiply_policy::fft));
+}
+
+} //namespace bench
+
+int main(int argc, char** argv) {
+	using namespace bench;
+
+	options opt;
+	for(int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		auto value = [arg](std::string_view key) -> std::optional<std::string_view> {
+			if(arg.substr(0, key.size()) != key) return std::nullopt;
+			return arg.substr(key.size());
+		};
+		if(auto v = value("--min-size="))    opt.min_size = std::strtoull(v->data(), nullptr, 10);
+		else if(auto v = value("--max-size=")) opt.max_size = std::strtoull(v->data(), nullptr, 10);
+		else if(auto v = value("--warmup="))   opt.warmup = std::strtoull(v->data(), nullptr, 10);
+		else if(auto v = value("--reps="))     opt.repetitions = std::strtoull(v->data(), nullptr, 10);
+		else if(auto v = value("--filter="))   opt.filter = *v;
+		else {
+			std::cerr << "usage: " << argv[0] << " [--min-size=N] [--max-size=N] [--warmup=N] [--reps=N] [--filter=container/op/distribution]\n";
+			return 1;
+		}
+	}
+	if(opt.repetitions == 0) opt.repetitions = 1;
+
+	runner r{opt};
+	for(size_t n = opt.min_size; n <= opt.max_size; n *= 10) {
+		for(distribution dist: distributions) {
+			bench_container<linked_list<int>>(r, "linked_list", dist, n);
+			bench_container<double_list<int>>(r, "double_list", dist, n);
+			bench_container<std::forward_list<int>>(r, "std::forward_list", dist, n);
+			bench_container<std::list<int>>(r, "std::list", dist, n);
+			bench_container<std::vector<int>>(r, "std::vector", dist, n);
+			bench_polynormial(r, dist, n);
+			bench_polynormial_eval(r, dist, n);
+			bench_polynormial_stream(r, dist, n);
+			bench_polynormial_multiply(r, dist, n);
+		}
+	}
+}
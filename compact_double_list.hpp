@@ -0,0 +1,705 @@
+#pragma once
+
+//以32位下标链接的紧凑双向链表实现
+
+#include <new>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <concepts>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+namespace rais::study {
+
+using std::size_t;
+using std::byte;
+using std::move;
+using std::forward;
+using std::initializer_list;
+using std::allocator;
+using std::allocator_traits;
+using std::less;
+using std::less_equal;
+
+//concepts
+using std::same_as;
+using std::predicate;
+using std::convertible_to;
+
+template <typename T>
+struct compact_node {
+	std::uint32_t priv, //index of privious node, npos if it's freed
+	              next; //index of next node, or of the next free node if it's freed
+	alignas(T) byte storage[sizeof(T)];
+
+	//the element is constructed in storage by placement new, launder makes the pointer refer to it
+	T& data() noexcept{return *std::launder(reinterpret_cast<T*>(storage)); }
+	const T& data() const noexcept{return *std::launder(reinterpret_cast<const T*>(storage)); }
+};
+
+
+/*
+ * 紧凑双链表实现.
+ * - 所有节点存放在一块连续的可增长内存池中, 节点之间用32位下标链接, 每个节点的额外开销为8字节(不计对齐)
+ * - 与double_list相同, 链表为空时head == npos, 不为空时pool[head].priv == tail, pool[tail].next == npos
+ * - 被删除的节点通过next链接成空闲链表并优先复用, 下标[used, cap)的节点从未被使用过
+ * - 内存池增长时节点下标不变, 但元素会被移动, 因此指向元素的指针与引用失效, 迭代器保存下标因此仍然有效
+ * - T可平凡析构时clear()与析构为O(1)
+ * - sort与merge_sort只重新链接下标, 不移动元素; 同一链表内的splice为O(1)的下标重新链接.
+ *   每个链表有各自的内存池, 因此merge与来自另一个链表的splice需要把元素移动到本链表的内存池中, 为O(n)
+ * - 移动元素或比较抛出异常时链表仍然有效且不泄漏元素(基本保证), 但元素的顺序不确定
+ */
+template <typename T, typename AllocatorT = allocator<T>>
+class compact_double_list {
+
+public:
+
+	using element_t = T;
+	using node_t = compact_node<T>;
+	using index_t = std::uint32_t;
+	using allocator_t = AllocatorT;
+	using value_traits = allocator_traits<AllocatorT>;
+	using node_allocator_t = typename allocator_traits<AllocatorT>::template rebind_alloc<node_t>;
+	using node_traits = allocator_traits<node_allocator_t>;
+
+	static constexpr index_t npos = static_cast<index_t>(-1);
+
+	struct iterator {
+	private:
+		node_t** pool; //points to the pool pointer of the list, so that the iterator survives the growth
+		index_t it;
+
+	public:
+		iterator(node_t** pool, index_t it): pool{pool}, it{it} {}
+		T& operator*() {return (*pool)[it].data(); }
+		const T& operator*() const{ return (*pool)[it].data(); }
+		T* operator->() noexcept{return &((*pool)[it].data()); }
+		const T* operator->() const noexcept{return &((*pool)[it].data()); }
+		iterator& operator++() {it = (*pool)[it].next; return *this;}
+		iterator operator++(int) {auto temp = *this; ++*this; return temp;}
+		iterator& operator--() {it = (*pool)[it].priv; return *this;}
+		iterator operator--(int) {auto temp = *this; --*this; return temp;}
+		bool operator==(const iterator& other) const noexcept{return it == other.it; }
+		bool operator!=(const iterator& other) const noexcept{return it != other.it; }
+
+		index_t get_index() const noexcept{return it; }
+	};
+
+	struct const_iterator {
+	private:
+		node_t* const* pool;
+		index_t it;
+
+	public:
+		const_iterator(node_t* const* pool, index_t it): pool{pool}, it{it} {}
+		const T& operator*() const{ return (*pool)[it].data(); }
+		const T* operator->() const noexcept{return &((*pool)[it].data()); }
+		const_iterator& operator++() {it = (*pool)[it].next; return *this;}
+		const_iterator operator++(int) {auto temp = *this; ++*this; return temp;}
+		const_iterator& operator--() {it = (*pool)[it].priv; return *this;}
+		const_iterator operator--(int) {auto temp = *this; --*this; return temp;}
+		bool operator==(const const_iterator& other) const noexcept{return it == other.it; }
+		bool operator!=(const const_iterator& other) const noexcept{return it != other.it; }
+
+		index_t get_index() const noexcept{return it; }
+	};
+	using iterator_t = iterator;
+	using const_iterator_t = const_iterator;
+
+protected:
+
+	node_t* pool = nullptr;
+	index_t cap = 0;
+	index_t used = 0;              //the high water mark of the pool
+	index_t free_head = npos;      //the freed nodes in [0, used)
+	index_t head = npos;
+	size_t len = 0;
+	[[no_unique_address]] node_allocator_t alloc;
+
+public:
+
+	compact_double_list() {}
+	explicit compact_double_list(const AllocatorT& alloc): alloc(alloc) {}
+	compact_double_list(initializer_list<T> list, const AllocatorT& alloc = {}): alloc(alloc) {
+		append_or_release(list.begin(), list.end(), list.size());
+	}
+	compact_double_list(const compact_double_list& other): alloc(node_traits::select_on_container_copy_construction(other.alloc)) {
+		//the copy is compacted into [0, len)
+		append_or_release(other.begin(), other.end(), other.len);
+	}
+	compact_double_list(compact_double_list&& other) noexcept: alloc(move(other.alloc)) {
+		steal(other);
+	}
+	compact_double_list& operator=(const compact_double_list& other) {
+		if(this == &other) return *this;
+		clear();
+		if constexpr(node_traits::propagate_on_container_copy_assignment::value) {
+			if(alloc != other.alloc) release();
+			alloc = other.alloc;
+		}
+		reserve(other.len);
+		for(const auto& i: other) push(i);
+		return *this;
+	}
+	compact_double_list& operator=(compact_double_list&& other) noexcept(node_traits::propagate_on_container_move_assignment::value or node_traits::is_always_equal::value) {
+		if(this == &other) return *this;
+		clear();
+		if constexpr(node_traits::propagate_on_container_move_assignment::value) {
+			release();
+			alloc = move(other.alloc);
+		}else if(alloc != other.alloc) {
+			//the pool of other can not be deallocated by alloc, move the elements one by one
+			for(auto& i: other) push(move(i));
+			other.clear();
+			return *this;
+		}else {
+			release();
+		}
+		steal(other);
+		return *this;
+	}
+
+	~compact_double_list() {
+		clear();
+		release();
+	}
+
+	size_t length() const noexcept{ return len; }
+	size_t size() const noexcept{ return len; }
+	size_t capacity() const noexcept{ return cap; }
+
+	allocator_t get_allocator() const noexcept{ return allocator_t(alloc); }
+
+	//no zero length check
+	T& front() {return pool[head].data(); }
+	const T& front() const{return pool[head].data(); }
+	T& back() {return pool[pool[head].priv].data(); }
+	const T& back() const{return pool[pool[head].priv].data(); }
+
+	iterator_t begin()              noexcept{return {&pool, head}; }
+	iterator_t end()                noexcept{return {&pool, npos}; }
+	const_iterator_t begin()  const noexcept{return {&pool, head}; }
+	const_iterator_t end()    const noexcept{return {&pool, npos}; }
+	const_iterator_t cbegin() const noexcept{return {&pool, head}; }
+	const_iterator_t cend()   const noexcept{return {&pool, npos}; }
+
+	bool is_empty() const noexcept{return head == npos; }
+
+	void reserve(size_t n) {
+		if(n > cap) grow(n);
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	compact_double_list& push(U&& val) {
+		index_t i = new_node(forward<U>(val));
+		if(head == npos) {
+			head = i;
+			pool[i].priv = i;
+		}else {
+			index_t tail = pool[head].priv;
+			pool[i].priv = tail;
+			pool[tail].next = i;
+			pool[head].priv = i;
+		}
+		pool[i].next = npos;
+		len++;
+		return *this;
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	compact_double_list& unshift(U&& val) {
+		index_t i = new_node(forward<U>(val));
+		if(head == npos) {
+			pool[i].priv = i;
+			pool[i].next = npos;
+		}else {
+			pool[i].priv = pool[head].priv;
+			pool[i].next = head;
+			pool[head].priv = i;
+		}
+		head = i;
+		len++;
+		return *this;
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	compact_double_list& insert(size_t index, U&& val) {
+		if(index == 0)  return unshift(forward<U>(val));
+		if(index >= len) return push(forward<U>(val));
+
+		link_before(get_node(index), new_node(forward<U>(val)));
+		len++;
+		return *this;
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	compact_double_list& insert(iterator_t it, U&& val) {
+		if(it.get_index() == head) return unshift(forward<U>(val));
+		if(it.get_index() == npos) return push(forward<U>(val));
+
+		link_before(it.get_index(), new_node(forward<U>(val)));
+		len++;
+		return *this;
+	}
+
+	T& operator[](size_t index) {
+		//no zero length and boundary check
+		return pool[get_node(index)].data();
+	}
+	const T& operator[](size_t index) const{
+		return pool[get_node(index)].data();
+	}
+
+	T* get_ptr(size_t index) {
+		if(index >= len) return nullptr;
+		return &(pool[get_node(index)].data());
+	}
+	const T* get_ptr(size_t index) const{
+		if(index >= len) return nullptr;
+		return &(pool[get_node(index)].data());
+	}
+
+	T shift() {
+		//no zero length check
+		T temp = move(front());
+		unlink(head);
+		return temp;
+	}
+
+	T pop() {
+		//no zero length check
+		T temp = move(back());
+		unlink(pool[head].priv);
+		return temp;
+	}
+
+	bool erase(size_t index) {
+		if(index >= len) return false;
+		unlink(get_node(index));
+		return true;
+	}
+
+	void erase(iterator_t it) {
+		unlink(it.get_index());
+	}
+
+	void clear() noexcept{
+		//O(1) for trivially destructible T, the pool is kept
+		if constexpr(!std::is_trivially_destructible_v<T>) {
+			allocator_t value_alloc(alloc);
+			for(index_t i = head; i != npos; i = pool[i].next) value_traits::destroy(value_alloc, &(pool[i].data()));
+		}
+		used = 0;
+		free_head = npos;
+		head = npos;
+		len = 0;
+	}
+
+	void reverse() noexcept{
+		if(len <= 1) return;
+
+		index_t pos = head;
+		do {
+			//swap priv and next
+			index_t temp = pool[pos].priv;
+			pool[pos].priv = pool[pos].next;
+			pool[pos].next = temp;
+			pos = pool[pos].priv; //point to next node, exectly
+		}while(pool[pos].next != npos);
+		pool[pos].next = pool[pos].priv;
+		pool[pos].priv = head;
+		pool[head].next = npos;
+		head = pos;
+	}
+
+	template <typename CompareT = less_equal<T>> //where CompareT should be less_equal<T> to match less<T>{}
+	requires predicate<CompareT, T, T>
+	bool is_sorted(const CompareT& comp = {}) const{
+		if(head == npos) return true;
+		for(index_t i = head; pool[i].next != npos; i = pool[i].next) {
+			if( !comp(pool[i].data(), pool[pool[i].next].data()) ) return false;
+		}
+		return true;
+	}
+
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void merge(compact_double_list&& other, const CompareT& comp = {}) {
+		//if a < b in some order, then comp(a, b) should returns true, otherwise returns false.
+		//merge two 'sorted' lists to one, stable. the elements of other are moved into the pool of *this, O(n + m)
+		if(this == &other or other.is_empty()) return;
+		if(is_empty() and alloc == other.alloc) {
+			release();
+			steal(other);
+			return;
+		}
+		reserve(len + other.len);
+		index_t first = head,
+		        second = npos;
+		//the elements of other are pushed, so that a throwing move leaves both lists valid (the pushed ones unsorted),
+		//then the two sorted chains are split and merged by 'next'
+		for(auto& i: other) {
+			push(move(i));
+			if(second == npos) second = pool[head].priv;
+		}
+		other.clear();
+		if(first != npos) pool[pool[second].priv].next = npos;
+		try {
+			relink(merge_chains(first, second, comp));
+		}catch(...) {
+			recover();
+			throw;
+		}
+	}
+
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void sort(const CompareT& comp = {}) {
+		merge_sort(comp);
+	}
+
+	//bottom-up merge sort, stable, O(N * log2(N)): only the indices are relinked, the elements are not moved.
+	//'next' is relinked during the merge passes, 'priv' is rebuilt in one final sweep
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void merge_sort(const CompareT& comp = {}) {
+		if(len <= 1) return;
+
+		//bins[i] is a sorted chain of 2^i nodes or npos, the higher bins hold the earlier nodes
+		index_t bins[64];
+		std::fill(bins, bins + 64, npos);
+		index_t pos = head;
+		try {
+			while(pos != npos) {
+				index_t carry = pos;
+				pos = pool[pos].next;
+				pool[carry].next = npos;
+				size_t i = 0;
+				for(; bins[i] != npos; i++) {
+					carry = merge_chains(bins[i], carry, comp);
+					bins[i] = npos;
+				}
+				bins[i] = carry;
+			}
+			index_t result = npos;
+			for(index_t bin: bins) {
+				if(bin != npos) result = result == npos ? bin : merge_chains(bin, result, comp);
+			}
+			relink(result);
+		}catch(...) {
+			recover();
+			throw;
+		}
+	}
+
+	//move the elements [first, last) of other in front of pos.
+	//O(1) by relinking the indices if other is *this, where pos should not be in [first, last);
+	//otherwise the elements are moved into the pool of *this, O(distance(first, last))
+	void splice(iterator_t pos, compact_double_list& other, iterator_t first, iterator_t last) {
+		if(first == last) return;
+		if(&other == this) {
+			//moving a range in front of itself changes nothing
+			if(pos == first) return;
+			index_t range_first = first.get_index(),
+			        range_last = unlink_range(range_first, last.get_index());
+			link_range(pos.get_index(), range_first, range_last);
+			return;
+		}
+		while(first != last) {
+			insert(pos, move(*first));
+			other.erase(first++);
+		}
+	}
+
+	//move the element it of other in front of pos
+	void splice(iterator_t pos, compact_double_list& other, iterator_t it) {
+		splice(pos, other, it, ++iterator_t{it});
+	}
+
+	//move all the elements of other in front of pos
+	void splice(iterator_t pos, compact_double_list& other) {
+		if(&other == this) return;
+		splice(pos, other, other.begin(), other.end());
+	}
+
+	friend void swap(compact_double_list& a, compact_double_list& b) noexcept{
+		//no allocator equality check when they are not propagated, like std::list
+		using std::swap;
+		if constexpr(node_traits::propagate_on_container_swap::value) swap(a.alloc, b.alloc);
+		swap(a.pool, b.pool);
+		swap(a.cap, b.cap);
+		swap(a.used, b.used);
+		swap(a.free_head, b.free_head);
+		swap(a.head, b.head);
+		swap(a.len, b.len);
+	}
+
+	template <typename OutputStreamT>
+	requires requires(OutputStreamT& os, const T& val, char c, const char* s) {
+		{os << val}->same_as<OutputStreamT&>;
+		{os << c}->same_as<OutputStreamT&>;
+		{os << s}->same_as<OutputStreamT&>;
+	}
+	friend OutputStreamT& operator<<(OutputStreamT& os, const compact_double_list& list) {
+		os << '[';
+		if(list.size() != 0) {
+			os << *list.cbegin();
+			for(auto it = ++list.cbegin(); it != list.cend(); ++it) {
+				os << ", " << *it;
+			}
+		}
+		return os << ']';
+	}
+
+protected:
+
+	template <typename... Args>
+	index_t new_node(Args&&... args) {
+		//construct an element in a free node, the links are left to the caller
+		allocator_t value_alloc(alloc);
+		if(free_head != npos) {
+			index_t i = free_head;
+			value_traits::construct(value_alloc, &(pool[i].data()), forward<Args>(args)...);
+			free_head = pool[i].next;
+			return i;
+		}
+		if(used == cap) {
+			//construct the element before relocating, since args might refer to an element in the pool
+			size_t new_cap = cap < 8 ? 8 : size_t{cap} * 2;
+			if(new_cap >= npos) new_cap = npos - 1;
+			if(used >= new_cap) throw std::length_error("compact_double_list: too many nodes for 32-bit indices");
+			node_t* new_pool = node_traits::allocate(alloc, new_cap);
+			try {
+				value_traits::construct(value_alloc, &(new_pool[used].data()), forward<Args>(args)...);
+			}catch(...) {
+				node_traits::deallocate(alloc, new_pool, new_cap);
+				throw;
+			}
+			try {
+				relocate(new_pool, static_cast<index_t>(new_cap));
+			}catch(...) {
+				value_traits::destroy(value_alloc, &(new_pool[used].data()));
+				node_traits::deallocate(alloc, new_pool, new_cap);
+				throw;
+			}
+		}else {
+			value_traits::construct(value_alloc, &(pool[used].data()), forward<Args>(args)...);
+		}
+		return used++;
+	}
+
+	void grow(size_t n) {
+		if(n >= npos) throw std::length_error("compact_double_list: too many nodes for 32-bit indices");
+		node_t* new_pool = node_traits::allocate(alloc, n);
+		try {
+			relocate(new_pool, static_cast<index_t>(n));
+		}catch(...) {
+			node_traits::deallocate(alloc, new_pool, n);
+			throw;
+		}
+	}
+
+	void relocate(node_t* new_pool, index_t new_cap) {
+		//move the nodes [0, used) to new_pool, the indices are unchanged.
+		//the elements are copied if their move constructor might throw, so that the pool is unchanged if it throws,
+		//then the caller deallocates new_pool
+		if(pool != nullptr) {
+			if constexpr(std::is_trivially_copyable_v<T>) {
+				std::memcpy(static_cast<void*>(new_pool), static_cast<const void*>(pool), sizeof(node_t) * used);
+			}else {
+				allocator_t value_alloc(alloc);
+				for(index_t i = 0; i < used; i++) {
+					new_pool[i].priv = pool[i].priv;
+					new_pool[i].next = pool[i].next;
+				}
+				index_t i = head;
+				try {
+					for(; i != npos; i = pool[i].next) value_traits::construct(value_alloc, &(new_pool[i].data()), std::move_if_noexcept(pool[i].data()));
+				}catch(...) {
+					for(index_t j = head; j != i; j = pool[j].next) value_traits::destroy(value_alloc, &(new_pool[j].data()));
+					throw;
+				}
+				for(i = head; i != npos; i = pool[i].next) value_traits::destroy(value_alloc, &(pool[i].data()));
+			}
+			node_traits::deallocate(alloc, pool, cap);
+		}
+		pool = new_pool;
+		cap = new_cap;
+	}
+
+	void release() noexcept{
+		//deallocate the pool, assume that the list is cleared
+		if(pool != nullptr) node_traits::deallocate(alloc, pool, cap);
+		pool = nullptr;
+		cap = 0;
+	}
+
+	void steal(compact_double_list& other) noexcept{
+		//assume that the pool of *this is released
+		pool = other.pool;
+		cap = other.cap;
+		used = other.used;
+		free_head = other.free_head;
+		head = other.head;
+		len = other.len;
+		other.pool = nullptr;
+		other.cap = other.used = 0;
+		other.free_head = other.head = npos;
+		other.len = 0;
+	}
+
+	void link_before(index_t pos, index_t i) noexcept{
+		//pos is not the head
+		index_t before = pool[pos].priv;
+		pool[i].priv = before;
+		pool[i].next = pos;
+		pool[before].next = i;
+		pool[pos].priv = i;
+	}
+
+	template <typename CompareT>
+	index_t merge_chains(index_t a, index_t b, const CompareT& comp) {
+		//merge two sorted chains which are linked by 'next' only, a is in front of b, so that takes a first when they are equal
+		index_t first = npos,
+		      * pos = &first;
+		while(a != npos and b != npos) {
+			if( comp(pool[b].data(), pool[a].data()) ) {
+				*pos = b;
+				b = pool[b].next;
+			}else {
+				*pos = a;
+				a = pool[a].next;
+			}
+			pos = &(pool[*pos].next);
+		}
+		*pos = a != npos ? a : b;
+		return first;
+	}
+
+	template <typename InputIteratorT>
+	void append_or_release(InputIteratorT first, InputIteratorT last, size_t n) {
+		//for the constructors, whose destructor is not called if they throw
+		try {
+			reserve(n);
+			for(; first != last; ++first) push(*first);
+		}catch(...) {
+			clear();
+			release();
+			throw;
+		}
+	}
+
+	void recover() noexcept{
+		//a comparison threw when the nodes were partly relinked by 'next', 
+		//link all the constructed nodes by their indices, where the freed ones have priv == npos
+		index_t first = npos,
+		      * pos = &first;
+		for(index_t i = 0; i < used; i++) {
+			if(pool[i].priv == npos) continue;
+			*pos = i;
+			pos = &(pool[i].next);
+		}
+		*pos = npos;
+		relink(first);
+	}
+
+	void relink(index_t first) noexcept{
+		//the nodes from first are linked by 'next' only, rebuild 'priv' and make first the head
+		head = first;
+		index_t prev = npos;
+		for(index_t pos = head; pos != npos; pos = pool[pos].next) {
+			pool[pos].priv = prev;
+			prev = pos;
+		}
+		if(head != npos) pool[head].priv = prev;
+	}
+
+	index_t unlink_range(index_t first, index_t last) noexcept{
+		//unlink [first, last) where last might be npos, returns the last node of the range, the length is unchanged
+		index_t tail = pool[head].priv,
+		        range_last = last == npos ? tail : pool[last].priv;
+		if(first == head) {
+			head = last;
+			if(last != npos) pool[last].priv = tail;
+		}else {
+			pool[pool[first].priv].next = last;
+			if(last != npos) pool[last].priv = pool[first].priv;
+			else pool[head].priv = pool[first].priv;
+		}
+		pool[range_last].next = npos;
+		return range_last;
+	}
+
+	void link_range(index_t pos, index_t first, index_t last) noexcept{
+		//link [first, last] in front of pos, where pos might be npos
+		if(head == npos) {
+			head = first;
+			pool[first].priv = last;
+		}else if(pos == npos) {
+			index_t tail = pool[head].priv;
+			pool[tail].next = first;
+			pool[first].priv = tail;
+			pool[head].priv = last;
+		}else if(pos == head) {
+			pool[first].priv = pool[head].priv;
+			pool[last].next = head;
+			pool[head].priv = last;
+			head = first;
+			return;
+		}else {
+			index_t before = pool[pos].priv;
+			pool[before].next = first;
+			pool[first].priv = before;
+		}
+		pool[last].next = pos;
+		if(pos != npos) pool[pos].priv = last;
+	}
+
+	void unlink(index_t i) noexcept{
+		if(i == head) {
+			head = pool[i].next;
+			if(head != npos) pool[head].priv = pool[i].priv;
+		}else if(pool[i].next == npos) {
+			//unlink tail node
+			index_t before = pool[i].priv;
+			pool[before].next = npos;
+			pool[head].priv = before;
+		}else {
+			pool[pool[i].priv].next = pool[i].next;
+			pool[pool[i].next].priv = pool[i].priv;
+		}
+		allocator_t value_alloc(alloc);
+		value_traits::destroy(value_alloc, &(pool[i].data()));
+		pool[i].priv = npos;
+		pool[i].next = free_head;
+		free_head = i;
+		len--;
+	}
+
+	index_t get_node(size_t index) const noexcept{
+		//no boundary and zero length check
+		index_t pos = head;
+		if(index <= len / 2) {
+			//indexing from head
+			for(size_t i = 0; i < index; i++) pos = pool[pos].next;
+		}else {
+			//indexing from tail
+			for(size_t i = 0; i < (len - index); i++) pos = pool[pos].priv;
+		}
+		return pos;
+	}
+
+}; //class compact_double_list<T, AllocatorT>
+
+
+} //namespace rais::study
@@ -0,0 +1,250 @@
+#pragma once
+
+//基于双向链表的线程安全双端队列实现
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <concepts>
+#include <optional>
+#include <condition_variable>
+
+#include <double_list.hpp>
+
+namespace rais::study {
+
+using std::size_t;
+using std::move;
+using std::forward;
+using std::allocator;
+
+//concepts
+using std::convertible_to;
+
+
+/*
+ * 线程安全的双端队列实现.
+ * - 队列由前后两个double_list组成, 元素顺序为front中的元素之后接back中的元素,
+ *   两者各有一把锁, 因此在两端操作的生产者与消费者互不竞争
+ * - 一端为空时同时持有两把锁(总是先front_mutex后back_mutex), 把另一个链表靠近这一端的一半节点splice过来,
+ *   因此pop均摊为O(1), 且不会分配内存
+ * - try_pop_*不阻塞, 队列为空时返回std::nullopt; pop_*在队列为空时阻塞, 直到有元素或队列被close()
+ * - push在锁外分配并构造节点, 在锁内只做O(1)的链接; 批量操作以double_list为单位, 批量push会同时持有两把锁
+ * - 前后两个链表使用同一个分配器实例, 节点在两者之间移动后仍由相等的分配器释放;
+ *   两端的操作与锁外的分配可能同时进行, 因此分配器需要是线程安全的(如std::allocator), slab_allocator不满足
+ */
+template <typename T, typename AllocatorT = allocator<T>>
+class concurrent_double_list {
+
+public:
+
+	using element_t = T;
+	using list_t = double_list<T, AllocatorT>;
+	using allocator_t = AllocatorT;
+
+protected:
+
+	list_t front_list;
+	list_t back_list;
+	mutable std::mutex front_mutex;
+	mutable std::mutex back_mutex;
+
+	std::atomic<size_t> count = 0;
+	std::atomic<size_t> waiters = 0;
+	std::atomic<bool> closed = false;
+	std::mutex wait_mutex;
+	std::condition_variable not_empty;
+
+public:
+
+	concurrent_double_list(): concurrent_double_list(AllocatorT{}) {}
+	explicit concurrent_double_list(const AllocatorT& alloc): front_list(alloc), back_list(alloc) {}
+	concurrent_double_list(const concurrent_double_list&) = delete;
+	concurrent_double_list& operator=(const concurrent_double_list&) = delete;
+
+	//a snapshot, which might be out of date when it's returned
+	size_t size() const noexcept{return count.load(); }
+	bool is_empty() const noexcept{return count.load() == 0; }
+
+	allocator_t get_allocator() const noexcept{return front_list.get_allocator(); }
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	void push_back(U&& val) {
+		//the node has no block, splicing it doesn't touch the blocks shared with the other part
+		list_t item{get_allocator()};
+		item.push(forward<U>(val));
+		{
+			std::lock_guard lock{back_mutex};
+			back_list.splice(back_list.end(), item);
+			count++;
+		}
+		notify(false);
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	void push_front(U&& val) {
+		//the node has no block, splicing it doesn't touch the blocks shared with the other part
+		list_t item{get_allocator()};
+		item.push(forward<U>(val));
+		{
+			std::lock_guard lock{front_mutex};
+			front_list.splice(front_list.begin(), item);
+			count++;
+		}
+		notify(false);
+	}
+
+	//O(1), the nodes of items are relinked to the back, items should use an equal allocator
+	void push_back(list_t&& items) {
+		size_t n = items.size();
+		if(n == 0) return;
+		{
+			//the node blocks of items might be merged with the ones shared by both parts
+			std::scoped_lock locks{front_mutex, back_mutex};
+			back_list.splice(back_list.end(), items);
+			count += n;
+		}
+		notify(true);
+	}
+
+	void push_front(list_t&& items) {
+		size_t n = items.size();
+		if(n == 0) return;
+		{
+			//the node blocks of items might be merged with the ones shared by both parts
+			std::scoped_lock locks{front_mutex, back_mutex};
+			front_list.splice(front_list.begin(), items);
+			count += n;
+		}
+		notify(true);
+	}
+
+	std::optional<T> try_pop_front() {
+		std::unique_lock front_lock{front_mutex};
+		if(front_list.is_empty()) {
+			std::lock_guard back_lock{back_mutex};
+			if(back_list.is_empty()) return std::nullopt;
+			refill_front();
+		}
+		count--;
+		return front_list.shift();
+	}
+
+	std::optional<T> try_pop_back() {
+		{
+			std::lock_guard back_lock{back_mutex};
+			if(!back_list.is_empty()) {
+				count--;
+				return back_list.pop();
+			}
+		}
+		//keep the lock order
+		std::scoped_lock locks{front_mutex, back_mutex};
+		if(back_list.is_empty()) {
+			if(front_list.is_empty()) return std::nullopt;
+			refill_back();
+		}
+		count--;
+		return back_list.pop();
+	}
+
+	//blocks until an element is popped, returns std::nullopt if the list is closed and empty
+	std::optional<T> pop_front() {
+		return wait_pop([this] {return try_pop_front(); });
+	}
+
+	std::optional<T> pop_back() {
+		return wait_pop([this] {return try_pop_back(); });
+	}
+
+	//pops at most n elements from the front, without blocking
+	list_t try_pop_front(size_t n) {
+		list_t result{get_allocator()};
+		std::lock_guard front_lock{front_mutex};
+		if(front_list.size() < n) {
+			std::lock_guard back_lock{back_mutex};
+			front_list.splice(front_list.end(), back_list);
+		}
+		if(n > front_list.size()) n = front_list.size();
+		if(n == 0) return result;
+		auto last = front_list.begin();
+		for(size_t i = 0; i < n; i++) ++last;
+		result.splice(result.end(), front_list, front_list.begin(), last, n);
+		count -= n;
+		return result;
+	}
+
+	//pops at most n elements from the back, without blocking, the result keeps their order in the list
+	list_t try_pop_back(size_t n) {
+		list_t result{get_allocator()};
+		std::scoped_lock locks{front_mutex, back_mutex};
+		if(back_list.size() < n) {
+			back_list.splice(back_list.begin(), front_list);
+		}
+		if(n > back_list.size()) n = back_list.size();
+		if(n == 0) return result;
+		typename list_t::iterator_t first{back_list.head->priv};
+		for(size_t i = 1; i < n; i++) --first;
+		result.splice(result.end(), back_list, first, back_list.end(), n);
+		count -= n;
+		return result;
+	}
+
+	//wakes up the blocked pops, the elements are still available
+	void close() {
+		closed = true;
+		std::lock_guard lock{wait_mutex};
+		not_empty.notify_all();
+	}
+
+	bool is_closed() const noexcept{return closed.load(); }
+
+protected:
+
+	template <typename TryPopT>
+	std::optional<T> wait_pop(TryPopT try_pop) {
+		for(;;) {
+			if(auto val = try_pop()) return val;
+			//waiters is increased before checking count, and a push increases count before checking waiters,
+			//so that one of them sees the other one
+			waiters++;
+			{
+				std::unique_lock lock{wait_mutex};
+				not_empty.wait(lock, [this] {return count.load() != 0 or closed.load(); });
+			}
+			waiters--;
+			if(closed.load() and count.load() == 0) return std::nullopt;
+		}
+	}
+
+	void notify(bool all) {
+		if(waiters.load() == 0) return;
+		std::lock_guard lock{wait_mutex};
+		if(all) not_empty.notify_all();
+		else not_empty.notify_one();
+	}
+
+	void refill_front() noexcept{
+		//both locks are held, front_list is empty, moves the front half of back_list to front_list
+		size_t n = (back_list.size() + 1) / 2;
+		auto last = back_list.begin();
+		for(size_t i = 0; i < n; i++) ++last;
+		front_list.splice(front_list.end(), back_list, back_list.begin(), last, n);
+	}
+
+	void refill_back() noexcept{
+		//both locks are held, back_list is empty, moves the back half of front_list to back_list
+		size_t n = (front_list.size() + 1) / 2;
+		typename list_t::iterator_t first{front_list.head->priv};
+		for(size_t i = 1; i < n; i++) --first;
+		back_list.splice(back_list.begin(), front_list, first, front_list.end(), n);
+	}
+
+}; //class concurrent_double_list<T, AllocatorT>
+
+
+} //namespace rais::study
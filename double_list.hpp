@@ -2,20 +2,34 @@
 
 //双向链表实现
 
+#include <memory>
+#include <ranges>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
+#include <iterator>
 #include <concepts>
+#include <functional>
 #include <initializer_list>
 
+#include <prefetch.hpp>
+#include <node_blocks.hpp>
+#include <node_handle.hpp>
+
 namespace rais::study {
 
 using std::size_t;
 using std::move;
 using std::forward;
 using std::initializer_list;
+using std::allocator;
+using std::allocator_traits;
+using std::less;
+using std::less_equal;
 
 //concepts
 using std::same_as;
+using std::predicate;
 using std::convertible_to;
 
 template <typename T>
@@ -44,16 +58,28 @@ struct double_node {
  * - 链表为空时头指针head == nullptr
  * - 链表不为空时head->priv == tail, 即头节点的前继指针指向尾节点, 
  *   但尾节点的后继指针指向nullptr, 即tail->next == nullptr
- * 
+ * - 记录最近一次按下标访问的节点与下标(cursor), 下一次按下标访问从head, tail与cursor中最近的一个开始,
+ *   因此顺序或邻近的下标访问均摊为O(1); 无法确定下标变化的结构修改会使cursor失效
+ * - 只有非const的按下标访问会更新cursor, const访问只读取它, 因此多个线程可以同时对同一个链表进行const访问
+ * - 范围构造, 拷贝构造与append_range的节点分配在一个连续的块中(node_blocks), assign与拷贝赋值复用已有的节点
+ * - relayout()把所有节点按链表顺序移动到一个新的连续块中, average_stride()为相邻节点的平均地址距离, 可据此决定何时调用
+ * - extract()取出的节点由节点句柄(node_handle)持有, 可以不经分配地插入到同一个或另一个链表中
+ * - PrefetchT为prefetch_policy::ahead<D>时, clear, reverse, merge, is_sorted, for_each与输出在遍历时预取前方第D个节点
  *
  */
-template <typename T>
+template <typename T, typename AllocatorT = allocator<T>, typename PrefetchT = prefetch_policy::none>
+requires prefetch_policy_type<PrefetchT>
 class double_list {
 
 public:
 
 	using element_t = T;
 	using node_t = double_node<T>;
+	using allocator_t = AllocatorT;
+	using prefetch_t = PrefetchT;
+	using node_allocator_t = typename allocator_traits<AllocatorT>::template rebind_alloc<node_t>;
+	using node_traits = allocator_traits<node_allocator_t>;
+	using node_handle_t = node_handle<node_t, node_allocator_t>;
 
 	struct iterator {
 	private:
@@ -100,50 +126,64 @@ public:
 	node_t* head = nullptr;
 	size_t len = 0;
 
+protected:
+
+	[[no_unique_address]] node_allocator_t alloc;
+	//the node and index of the last positional access, nullptr if it's invalidated
+	node_t* cursor = nullptr;
+	size_t cursor_index = 0;
+	node_blocks<node_t, node_allocator_t> blocks; //the nodes of the batch operations
+
+public:
 
 	double_list() {}
-	double_list(initializer_list<T> list) {
-		auto it = list.begin();
-		head = new node_t{*it};
-		node_t* pos = head;
-		++it;
-		for(; it != list.end(); ++it) {
-			pos->next = new node_t{*it, pos};
-			pos = pos->next;
-		}
-		pos->next = nullptr;
-		head->priv = pos;
-		len = list.size();
+	explicit double_list(const AllocatorT& alloc): alloc(alloc) {}
+	double_list(initializer_list<T> list, const AllocatorT& alloc = {}): alloc(alloc) {
+		build([&] {append_n(list.begin(), list.size()); });
 	}
-	double_list(const double_list& other) {
-		auto it = other.begin();
-		head = new node_t{*it};
-		node_t* pos = head;
-		++it;
-		for(; it != other.end(); ++it) {
-			pos->next = new node_t{*it, pos};
-			pos = pos->next;
-		}
-		pos->next = nullptr;
-		head->priv = pos;
-		len = other.len;
+	template <std::input_iterator IteratorT, std::sentinel_for<IteratorT> SentinelT>
+	requires convertible_to<std::iter_reference_t<IteratorT>, const T&>
+	double_list(IteratorT first, SentinelT last, const AllocatorT& alloc = {}): alloc(alloc) {
+		build([&] {append(move(first), move(last)); });
 	}
-	double_list(double_list&& other) noexcept: head{other.head}, len{other.len} {
+	double_list(const double_list& other): alloc(node_traits::select_on_container_copy_construction(other.alloc)) {
+		//the nodes are allocated in one block
+		build([&] {append_n(other.cbegin(), other.len); });
+	}
+	double_list(double_list&& other) noexcept: head{other.head}, len{other.len}, alloc(move(other.alloc)) {
 		other.head = nullptr;
 		other.len = 0;
+		other.cursor = nullptr;
+		blocks.adopt(other.blocks);
 	}
 	double_list& operator=(const double_list& other) {
+		//reuses the nodes of *this, only the difference of length is allocated or deallocated
 		if(this == &other) return *this;
-		auto temp = other;
-		return *this = move(temp);	
+		if constexpr(node_traits::propagate_on_container_copy_assignment::value) {
+			//the nodes can not be deallocated by the new allocator
+			if(alloc != other.alloc) clear();
+			alloc = other.alloc;
+		}
+		assign_n(other.cbegin(), other.len);
+		return *this;
 	}
-	double_list& operator=(double_list&& other) noexcept{
+	double_list& operator=(double_list&& other) noexcept(node_traits::propagate_on_container_move_assignment::value or node_traits::is_always_equal::value) {
 		if(this == &other) return *this;
 		clear();
+		if constexpr(node_traits::propagate_on_container_move_assignment::value) {
+			alloc = move(other.alloc);
+		}else if(alloc != other.alloc) {
+			//the nodes of other can not be deallocated by alloc, move the elements one by one
+			for(auto& i: other) push(move(i));
+			other.clear();
+			return *this;
+		}
 		head = other.head;
 		len = other.len;
 		other.head = nullptr;
 		other.len = 0;
+		other.cursor = nullptr;
+		blocks.adopt(other.blocks);
 		return *this;
 	}
 
@@ -154,6 +194,8 @@ public:
 	size_t length() const noexcept{ return len; } 
 	size_t size() const noexcept{ return len; }
 
+	allocator_t get_allocator() const noexcept{ return allocator_t(alloc); }
+
 	//no zero length check
 	T& front() {return head->data; }
 	const T& front() const{return head->data; }
@@ -175,13 +217,13 @@ public:
 	requires convertible_to<U, const T&>
 	double_list& push(U&& val) {
 		if(!head) {
-			head = new node_t{forward<U>(val)};
+			head = new_node(forward<U>(val));
 			head->priv = head;
 			head->next = nullptr;
 			// head<--head-->nullptr
 		}else {
 			node_t* tail = head->priv;
-			head->priv = tail->next = new node_t{forward<U>(val), tail, nullptr};
+			head->priv = tail->next = new_node(forward<U>(val), tail, nullptr);
 		}
 		len++;
 		return *this;
@@ -191,13 +233,14 @@ public:
 	requires convertible_to<U, const T&>
 	double_list& unshift(U&& val) {
 		if(!head) {
-			head = new node_t{forward<U>(val)};
+			head = new_node(forward<U>(val));
 			head->priv = head;
 			head->next = nullptr;
 		}else {
-			head = new node_t{forward<U>(val), head->priv, head};
+			head = new_node(forward<U>(val), head->priv, head);
 			head->next->priv = head;
 		}
+		cursor_index++;
 		len++;
 		return *this;
 	}
@@ -209,7 +252,9 @@ public:
 		if(index >= len) return push(forward<U>(val));
 		
 		node_t* pos = get_node(index);
-		pos->priv = pos->priv->next = new node_t{forward<U>(val), pos->priv, pos};
+		pos->priv = pos->priv->next = new_node(forward<U>(val), pos->priv, pos);
+		//the new node takes the index
+		cursor = pos->priv;
 		len++;
 		return *this;
 	}
@@ -220,13 +265,15 @@ public:
 		if(it.get_ptr() == head) return unshift(forward<U>(val));
 		if(it.get_ptr() == nullptr) return push(forward<U>(val));
 
-		it.get_ptr()->priv = it.get_ptr()->priv->next = new node_t{forward<U>(val), it.get_ptr()->priv, it.get_ptr()};
+		it.get_ptr()->priv = it.get_ptr()->priv->next = new_node(forward<U>(val), it.get_ptr()->priv, it.get_ptr());
+		cursor = nullptr;
 		len++;
 		return *this;
 	}
 
 	T& operator[](size_t index) {
-		return const_cast<T&>(static_cast<const double_list&>(*this)[index]);
+		//no zero length and boundary check
+		return get_node(index)->data;
 	}
 	const T& operator[](size_t index) const{
 		//no zero length and boundary check
@@ -235,13 +282,50 @@ public:
 	}
 
 	T* get_ptr(size_t index) {
-		return const_cast<T*>(static_cast<const double_list*>(this)->get_ptr(index));
+		if(index >= len) return nullptr;
+		return &get_node(index)->data;
 	}
 	const T* get_ptr(size_t index) const{
 		if(index >= len) return nullptr;
 		return &get_node(index)->data;
 	}
 
+	//replaces the elements, the existing nodes are reused, the extra nodes are allocated in one block
+	template <std::input_iterator IteratorT, std::sentinel_for<IteratorT> SentinelT>
+	requires convertible_to<std::iter_reference_t<IteratorT>, const T&>
+	double_list& assign(IteratorT first, SentinelT last) {
+		if constexpr(std::forward_iterator<IteratorT>) {
+			assign_n(first, static_cast<size_t>(std::ranges::distance(first, last)));
+		}else {
+			node_t* pos = head;
+			size_t n = 0;
+			for(; pos != nullptr and first != last; ++first, n++) {
+				pos->data = *first;
+				pos = pos->next;
+			}
+			if(pos != nullptr) erase_from(pos, n);
+			else append(move(first), move(last));
+		}
+		return *this;
+	}
+
+	double_list& assign(initializer_list<T> list) {
+		assign_n(list.begin(), list.size());
+		return *this;
+	}
+
+	//push the elements of range, the nodes are allocated in one block if the range is a forward range
+	template <std::ranges::input_range RangeT>
+	requires convertible_to<std::ranges::range_reference_t<RangeT>, const T&>
+	double_list& append_range(RangeT&& range) {
+		if constexpr(std::ranges::sized_range<RangeT>) {
+			append_n(std::ranges::begin(range), static_cast<size_t>(std::ranges::size(range)));
+		}else {
+			append(std::ranges::begin(range), std::ranges::end(range));
+		}
+		return *this;
+	}
+
 	T shift() {
 		//no zero length check
 		T temp = move(head->data);
@@ -251,7 +335,8 @@ public:
 			//len != 1
 			head->priv = old_head->priv;
 		}
-		delete old_head;
+		shift_cursor(old_head);
+		delete_node(old_head);
 		len--;
 		return temp;
 	}
@@ -268,7 +353,8 @@ public:
 			//len == 1
 			head = nullptr;
 		}
-		delete tail_node;
+		if(cursor == tail_node) cursor = nullptr;
+		delete_node(tail_node);
 		len--;
 		return temp;
 	}
@@ -280,62 +366,183 @@ public:
 			node_t* old_head = head;
 			head = head->next;
 			if(len != 1) head->priv = old_head->priv;
-			delete old_head;
+			shift_cursor(old_head);
+			delete_node(old_head);
 		}else if(index == len - 1){
 			//erase tail node
 			node_t* old_tail = head->priv;
 			old_tail->priv->next = nullptr;
 			head->priv = old_tail->priv;
-			delete old_tail;
+			if(cursor == old_tail) cursor = nullptr;
+			delete_node(old_tail);
 		}else {
 			node_t* pos = get_node(index);
 			pos->priv->next = pos->next;
 			pos->next->priv = pos->priv;
-			delete pos;
+			//the next node takes the index
+			cursor = pos->next;
+			delete_node(pos);
 		}
 		len--;
 		return true;
 	}
 
+	//takes the node out of the list without deallocating it, 
+	//the handle is empty if index is out of range
+	node_handle_t extract(size_t index) noexcept{
+		if(index >= len) return {};
+		node_t* pos = get_node(index);
+		node_t* next = pos->next;
+		unlink_range(pos, next);
+		len--;
+		//the next node takes the index
+		cursor = next;
+		return {pos, alloc, blocks};
+	}
+
+	//O(1)
+	node_handle_t extract(iterator_t it) noexcept{
+		//the index of it is unknown
+		cursor = nullptr;
+		unlink_range(it.get_ptr(), it.get_ptr()->next);
+		len--;
+		return {it.get_ptr(), alloc, blocks};
+	}
+
+	//the node of handle is linked without allocating, nothing happens if handle is empty,
+	//handle's allocator should be equal to this one's
+	double_list& push(node_handle_t&& handle) noexcept{
+		link_node(nullptr, handle);
+		return *this;
+	}
+
+	double_list& unshift(node_handle_t&& handle) noexcept{
+		if(handle.is_empty()) return *this;
+		link_node(head, handle);
+		cursor_index++;
+		return *this;
+	}
+
+	double_list& insert(size_t index, node_handle_t&& handle) noexcept{
+		if(handle.is_empty()) return *this;
+		if(index == 0)  return unshift(move(handle));
+		if(index >= len) return push(move(handle));
+		node_t* pos = get_node(index);
+		link_node(pos, handle);
+		//the new node takes the index
+		cursor = pos->priv;
+		return *this;
+	}
+
+	double_list& insert(iterator_t it, node_handle_t&& handle) noexcept{
+		if(handle.is_empty()) return *this;
+		cursor = nullptr;
+		link_node(it.get_ptr(), handle);
+		return *this;
+	}
+
 	void erase(iterator_t it) {
+		//the index of it is unknown
+		cursor = nullptr;
 		if(it.get_ptr() == head) {
 			//erase head node
 			node_t* old_head = head;
 			head = head->next;
 			if(len != 1) head->priv = old_head->priv;
-			delete old_head;
+			delete_node(old_head);
 		}else if(it.get_ptr()->next == nullptr) {
 			//erase tail node
 			it.get_ptr()->priv->next = nullptr;
 			head->priv = it.get_ptr()->priv;
-			delete it.get_ptr();
+			delete_node(it.get_ptr());
 		}else {
 			node_t* temp = it.get_ptr();
 			temp->priv->next = temp->next;
 			temp->next->priv = temp->priv;
-			delete temp;
+			delete_node(temp);
 		}
 		len--;
 	}
 
 
 	void clear() {
-		if(head == nullptr) return;
-		node_t* pos = head;
-		for(size_t i = 0; i < len - 1; i++) {
-			pos = pos->next;
-			delete pos->priv;
+		if(head != nullptr) {
+			node_t* pos = head;
+			prefetcher_t prefetcher{pos};
+			for(size_t i = 0; i < len - 1; i++) {
+				pos = pos->next;
+				prefetcher.step();
+				delete_node(pos->priv);
+			}
+			delete_node(pos);
 		}
-		delete pos;
 		head = nullptr;
 		len = 0;
+		cursor = nullptr;
+		blocks.release(alloc);
+	}
+
+	//moves the elements into one new block in list order and relinks them, to restore the memory locality after churn.
+	//invalidates the iterators and references, the elements are copied if their move constructor might throw.
+	//returns the bytes of the deallocated nodes minus the allocated ones, which is negative if the old blocks
+	//are still shared by other lists, the overhead of the allocator for each allocation is not counted
+	std::ptrdiff_t relayout() {
+		if(len == 0) return 0;
+		node_blocks<node_t, node_allocator_t> fresh;
+		node_t* block = nullptr;
+		size_t i = 0;
+		try {
+			block = fresh.allocate(alloc, len);
+			for(node_t* pos = head; pos != nullptr; pos = pos->next, i++) {
+				node_traits::construct(alloc, block + i, std::move_if_noexcept(pos->data), i == 0 ? nullptr : block + i - 1, block + i + 1);
+			}
+		}catch(...) {
+			while(i != 0) node_traits::destroy(alloc, block + --i);
+			fresh.release(alloc);
+			throw;
+		}
+		block[len - 1].next = nullptr;
+		block->priv = block + len - 1;
+
+		size_t freed = 0;
+		for(node_t* pos = head; pos != nullptr; ) {
+			node_t* temp = pos->next;
+			node_traits::destroy(alloc, pos);
+			if(!blocks.put(pos)) {
+				node_traits::deallocate(alloc, pos, 1);
+				freed += sizeof(node_t);
+			}
+			pos = temp;
+		}
+		freed += blocks.release(alloc);
+		blocks.adopt(fresh);
+		head = block;
+		//the indices are not changed
+		if(cursor != nullptr) cursor = block + cursor_index;
+		return static_cast<std::ptrdiff_t>(freed) - static_cast<std::ptrdiff_t>(len * sizeof(node_t));
+	}
+
+	//the average distance in bytes between the addresses of the adjacent nodes, O(n),
+	//it's sizeof(node_t) after relayout(), and grows as the nodes are scattered
+	double average_stride() const noexcept{
+		if(len < 2) return 0;
+		double sum = 0;
+		for(const node_t* pos = head; pos->next != nullptr; pos = pos->next) {
+			std::uintptr_t a = reinterpret_cast<std::uintptr_t>(pos),
+			               b = reinterpret_cast<std::uintptr_t>(pos->next);
+			sum += a < b ? b - a : a - b;
+		}
+		return sum / (len - 1);
 	}
 
 	void reverse() {
 		if(len <= 1) return;
+		cursor = nullptr;
 
 		node_t* pos = head;
+		prefetcher_t prefetcher{pos};
 		do {
+			prefetcher.step();
 			//swap pos->priv and pos->next
 			node_t* temp = pos->priv;
 			pos->priv = pos->next;
@@ -349,13 +556,179 @@ public:
 
 	}
 
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void merge(double_list&& other, const CompareT& comp = {}) {
+		//if a < b in some order, then comp(a, b) should returns true, otherwise returns false.
+		//merge two 'sorted' double_list to one, O(n + m) and stable, the nodes of other are relinked without allocating.
+		//no allocator equality check, other's allocator should be equal to this one's, like std::list
+		if(this == &other or other.is_empty()) return;
+		cursor = other.cursor = nullptr;
+		blocks.share(other.blocks);
+		if(is_empty()) {
+			head = other.head;
+			len = other.len;
+			other.head = nullptr;
+			other.len = 0;
+			return;
+		}
+		node_t*  tail = head->priv,
+		      *  other_tail = other.head->priv,
+		      *  ps = head,
+		      *  po = other.head,
+		      *  prev = nullptr,
+		      ** pos = &head;
+		prefetcher_t prefetcher_s{ps},
+		             prefetcher_o{po};
+		while(ps != nullptr and po != nullptr) {
+			node_t* taken;
+			if( comp(po->data, ps->data) ) {
+				taken = po;
+				po = po->next;
+				prefetcher_o.step();
+			}else {
+				taken = ps;
+				ps = ps->next;
+				prefetcher_s.step();
+			}
+			*pos = taken;
+			taken->priv = prev;
+			prev = taken;
+			pos = &(taken->next);
+		}
+		//one of them is not empty
+		if(ps != nullptr) {
+			*pos = ps;
+			ps->priv = prev;
+		}else {
+			*pos = po;
+			po->priv = prev;
+			tail = other_tail;
+		}
+		head->priv = tail;
+		len += other.len;
+		other.head = nullptr;
+		other.len = 0;
+	}
+
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void sort(const CompareT& comp = {}) {
+		merge_sort(comp);
+	}
+
+	//bottom-up merge sort, inplace and stable, O(N * log2(N)):
+	//only 'next' is relinked during the merge passes, 'priv' is rebuilt in one final sweep.
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void merge_sort(const CompareT& comp = {}) {
+		if(len <= 1) return;
+		cursor = nullptr;
+
+		//bins[i] is a sorted chain of 2^i nodes or nullptr, the higher bins hold the earlier nodes
+		node_t* bins[64] = {};
+		node_t* pos = head;
+		while(pos != nullptr) {
+			node_t* carry = pos;
+			pos = pos->next;
+			carry->next = nullptr;
+			size_t i = 0;
+			for(; bins[i] != nullptr; i++) {
+				carry = merge_chains(bins[i], carry, comp);
+				bins[i] = nullptr;
+			}
+			bins[i] = carry;
+		}
+		node_t* result = nullptr;
+		for(node_t* bin: bins) {
+			if(bin != nullptr) result = result == nullptr ? bin : merge_chains(bin, result, comp);
+		}
+
+		head = result;
+		node_t* prev = nullptr;
+		for(pos = head; pos != nullptr; pos = pos->next) {
+			pos->priv = prev;
+			prev = pos;
+		}
+		head->priv = prev;
+	}
+
+	template <typename CompareT = less_equal<T>> //where CompareT should be less_equal<T> to match sort(less<T>{})
+	requires predicate<CompareT, T, T>
+	bool is_sorted(const CompareT& comp = {}) const{
+		if(head == nullptr) return true;
+		prefetcher_t prefetcher{head};
+		for(const node_t* pos = head; pos->next != nullptr; pos = pos->next) {
+			if( !comp(pos->data, pos->next->data) ) return false;
+			prefetcher.step();
+		}
+		return true;
+	}
+
+	//calls fn on the elements in order, the nodes of a batch are collected before fn is called on them,
+	//so that fn on the collected elements does not wait for the next node to be loaded.
+	//fn should not change the structure of the list
+	template <size_t BatchSize = 8, typename FnT>
+	requires std::invocable<FnT&, T&>
+	void for_each(FnT fn) {
+		for_each_batch<BatchSize>(head, fn);
+	}
+
+	template <size_t BatchSize = 8, typename FnT>
+	requires std::invocable<FnT&, const T&>
+	void for_each(FnT fn) const{
+		for_each_batch<BatchSize>(static_cast<const node_t*>(head), fn);
+	}
+
+	//move the nodes [first, last) of other in front of pos, without allocating.
+	//O(1) if other is *this, otherwise O(distance(first, last)) to count the nodes,
+	//pos should not be in [first, last), no allocator equality check like merge()
+	void splice(iterator_t pos, double_list& other, iterator_t first, iterator_t last) {
+		if(first == last) return;
+		size_t n = 0;
+		if(&other != this) for(iterator_t it = first; it != last; ++it) n++;
+		splice(pos, other, first, last, n);
+	}
+
+	//O(1), where n is distance(first, last), which is ignored if other is *this
+	void splice(iterator_t pos, double_list& other, iterator_t first, iterator_t last, size_t n) noexcept{
+		//moving a range in front of itself changes nothing
+		if(first == last or pos == first) return;
+		cursor = other.cursor = nullptr;
+		node_t* range_last = other.unlink_range(first.get_ptr(), last.get_ptr());
+		link_range(pos.get_ptr(), first.get_ptr(), range_last);
+		if(&other != this) {
+			other.len -= n;
+			len += n;
+			blocks.share(other.blocks);
+		}
+	}
+
+	//O(1), move the node it of other in front of pos
+	void splice(iterator_t pos, double_list& other, iterator_t it) noexcept{
+		splice(pos, other, it, iterator_t{it.get_ptr()->next}, 1);
+	}
+
+	//O(1), move all the nodes of other in front of pos
+	void splice(iterator_t pos, double_list& other) noexcept{
+		if(&other == this) return;
+		splice(pos, other, other.begin(), other.end(), other.len);
+	}
+
 	friend void swap(double_list& a, double_list& b) noexcept{
+		//no allocator equality check when they are not propagated, like std::list
+		if constexpr(node_traits::propagate_on_container_swap::value) {
+			using std::swap;
+			swap(a.alloc, b.alloc);
+		}
+		swap(a.blocks, b.blocks);
 		node_t* temp_head = a.head;
 		size_t temp_len = a.len;
 		a.head = b.head;
 		a.len = b.len;
 		b.head = temp_head;
 		b.len = temp_len;
+		a.cursor = b.cursor = nullptr;
 	}
 
 	template <typename OutputStreamT>
@@ -367,8 +740,10 @@ public:
 	friend OutputStreamT& operator<<(OutputStreamT& os, const double_list& list) {
 		os << '[';
 		if(list.size() != 0) {
+			prefetcher_t prefetcher{list.head};
 			os << *list.cbegin();
 			for(auto it = ++list.cbegin(); it != list.cend(); ++it) {
+				prefetcher.step();
 				os << ", " << *it;
 			}
 		}
@@ -377,22 +752,241 @@ public:
 
 protected:
 
+	using prefetcher_t = node_prefetcher<node_t, PrefetchT::distance>;
+
+	template <size_t BatchSize, typename NodeT, typename FnT>
+	static void for_each_batch(NodeT* pos, FnT& fn) {
+		static_assert(BatchSize != 0);
+		NodeT* batch[BatchSize];
+		prefetcher_t prefetcher{pos};
+		while(pos != nullptr) {
+			size_t n = 0;
+			for(; n < BatchSize and pos != nullptr; n++) {
+				batch[n] = pos;
+				pos = pos->next;
+				prefetcher.step();
+			}
+			for(size_t i = 0; i < n; i++) fn(batch[i]->data);
+		}
+	}
+
+	template <typename... Args>
+	node_t* new_node(Args&&... args) {
+		//a spare node of the blocks is reused first
+		node_t* temp = blocks.take();
+		if(temp == nullptr) temp = node_traits::allocate(alloc, 1);
+		construct_node(temp, forward<Args>(args)...);
+		return temp;
+	}
+
+	template <typename... Args>
+	void construct_node(node_t* node, Args&&... args) {
+		try {
+			node_traits::construct(alloc, node, forward<Args>(args)...);
+		}catch(...) {
+			if(!blocks.put(node)) node_traits::deallocate(alloc, node, 1);
+			throw;
+		}
+	}
+
+	void delete_node(node_t* node) noexcept{
+		node_traits::destroy(alloc, node);
+		if(!blocks.put(node)) node_traits::deallocate(alloc, node, 1);
+	}
+
+	//constructs n > 0 nodes from it as a detached chain, and advances it, returns the first node, whose priv is the last node.
+	//the spare nodes are used first, then the rest are allocated in one block
+	template <typename IteratorT>
+	node_t* new_nodes(IteratorT& it, size_t n) {
+		node_t* first = nullptr,
+		      * priv = nullptr,
+		      * block = nullptr;
+		size_t used = 0, block_n = 0;
+		try {
+			for(size_t i = 0; i < n; ++it, i++) {
+				node_t* node = block != nullptr ? block + used++ : blocks.take();
+				if(node == nullptr and n - i >= blocks.min_block_nodes) {
+					block_n = n - i;
+					block = blocks.allocate(alloc, block_n);
+					node = block + used++;
+				}
+				if(node == nullptr) node = new_node(*it, priv);
+				else construct_node(node, *it, priv);
+				if(priv != nullptr) priv->next = node;
+				else first = node;
+				priv = node;
+			}
+		}catch(...) {
+			while(priv != nullptr) {
+				node_t* temp = priv->priv;
+				delete_node(priv);
+				priv = temp;
+			}
+			for(; used < block_n; used++) blocks.put(block + used);
+			throw;
+		}
+		priv->next = nullptr;
+		first->priv = priv;
+		return first;
+	}
+
+	template <typename BuildT>
+	void build(BuildT build_nodes) {
+		//for the constructors, the destructor is not called if they throw
+		try {
+			build_nodes();
+		}catch(...) {
+			clear();
+			throw;
+		}
+	}
+
+	template <typename IteratorT>
+	void append_n(IteratorT it, size_t n) {
+		if(n == 0) return;
+		node_t* first = new_nodes(it, n);
+		link_range(nullptr, first, first->priv);
+		len += n;
+	}
+
+	template <typename IteratorT, typename SentinelT>
+	void append(IteratorT first, SentinelT last) {
+		if constexpr(std::forward_iterator<IteratorT>) {
+			append_n(first, static_cast<size_t>(std::ranges::distance(first, last)));
+		}else {
+			for(; first != last; ++first) push(*first);
+		}
+	}
+
+	template <typename IteratorT>
+	void assign_n(IteratorT it, size_t n) {
+		node_t* pos = head;
+		size_t i = 0;
+		for(; i < n and pos != nullptr; i++, ++it) {
+			pos->data = *it;
+			pos = pos->next;
+		}
+		if(pos != nullptr) erase_from(pos, n);
+		else append_n(move(it), n - i);
+	}
+
+	//erase pos and the nodes after it, n is the new length
+	void erase_from(node_t* pos, size_t n) noexcept{
+		unlink_range(pos, nullptr);
+		len = n;
+		if(cursor != nullptr and cursor_index >= n) cursor = nullptr;
+		while(pos != nullptr) {
+			node_t* temp = pos->next;
+			delete_node(pos);
+			pos = temp;
+		}
+	}
+
+	template <typename CompareT>
+	requires predicate<CompareT, T, T>
+	static node_t* merge_chains(node_t* a, node_t* b, const CompareT& comp) {
+		//merge two sorted chains which are linked by 'next' only, a is in front of b, so that takes a first when they are equal
+		node_t*  first = nullptr,
+		      ** pos = &first;
+		while(a != nullptr and b != nullptr) {
+			if( comp(b->data, a->data) ) {
+				*pos = b;
+				b = b->next;
+			}else {
+				*pos = a;
+				a = a->next;
+			}
+			pos = &((*pos)->next);
+		}
+		*pos = a != nullptr ? a : b;
+		return first;
+	}
+
+	void link_node(node_t* pos, node_handle_t& handle) noexcept{
+		//link the node of handle in front of pos, where pos might be nullptr
+		if(handle.is_empty()) return;
+		node_t* node = handle.take(blocks);
+		link_range(pos, node, node);
+		len++;
+	}
+
+	node_t* unlink_range(node_t* first, node_t* last) noexcept{
+		//detach [first, last) from the list, where last might be nullptr, returns the last node of the range.
+		//len is not changed
+		node_t* tail = head->priv,
+		      * range_last = last != nullptr ? last->priv : tail,
+		      * before = first == head ? nullptr : first->priv;
+		if(before != nullptr) before->next = last;
+		else head = last;
+		if(last != nullptr) {
+			last->priv = before != nullptr ? before : tail;
+		}else if(head != nullptr) {
+			head->priv = before;
+		}
+		return range_last;
+	}
+
+	void link_range(node_t* pos, node_t* first, node_t* range_last) noexcept{
+		//link the detached range [first, range_last] in front of pos, where pos might be nullptr
+		if(head == nullptr) {
+			head = first;
+			first->priv = range_last;
+			range_last->next = nullptr;
+		}else if(pos == head) {
+			first->priv = head->priv;
+			range_last->next = head;
+			head->priv = range_last;
+			head = first;
+		}else if(pos == nullptr) {
+			node_t* tail = head->priv;
+			tail->next = first;
+			first->priv = tail;
+			range_last->next = nullptr;
+			head->priv = range_last;
+		}else {
+			node_t* before = pos->priv;
+			before->next = first;
+			first->priv = before;
+			range_last->next = pos;
+			pos->priv = range_last;
+		}
+	}
+
 	node_t* get_node(size_t index) {
-		return const_cast<node_t*>(static_cast<const double_list*>(this)->get_node(index)); 
+		//the result becomes the cursor, the const access doesn't write it
+		node_t* pos = const_cast<node_t*>(static_cast<const double_list*>(this)->get_node(index));
+		cursor = pos;
+		cursor_index = index;
+		return pos;
 	}
 	const node_t* get_node(size_t index) const{
 		//no boundary and zero length check
-		const node_t* pos = head;
-			if(index <= len / 2) {
+		//starts from whichever of head, tail and the cursor is the closest
+		size_t from_tail = len - 1 - index;
+		const node_t* pos;
+		if(cursor != nullptr and (index > cursor_index ? index - cursor_index : cursor_index - index) < (index < from_tail ? index : from_tail)) {
+			//indexing from cursor
+			pos = cursor;
+			if(index > cursor_index) for(size_t i = cursor_index; i < index; i++) pos = pos->next;
+			else                     for(size_t i = index; i < cursor_index; i++) pos = pos->priv;
+		}else if(index <= from_tail) {
 			//indexing from head
+			pos = head;
 			for(size_t i = 0; i < index; i++) pos = pos->next;
 		}else {
 			//indexing from tail
-			for(size_t i = 0; i < (len - index); i++) pos = pos->priv;
+			pos = head->priv;
+			for(size_t i = 0; i < from_tail; i++) pos = pos->priv;
 		}
 		return pos;
 	}
 
+	void shift_cursor(const node_t* old_head) noexcept{
+		//the head node is being removed, the others' indices decrease
+		if(cursor == old_head) cursor = nullptr;
+		else cursor_index--;
+	}
+
 
 }; //class double_list
 
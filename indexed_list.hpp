@@ -0,0 +1,490 @@
+#pragma once
+
+//带索引跳表层的链表实现
+
+#include <bit>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <concepts>
+#include <functional>
+#include <initializer_list>
+
+#include <linked_list.hpp>
+
+namespace rais::study {
+
+using std::size_t;
+using std::move;
+using std::forward;
+using std::initializer_list;
+using std::allocator;
+using std::allocator_traits;
+using std::less;
+using std::less_equal;
+
+//concepts
+using std::same_as;
+using std::predicate;
+using std::convertible_to;
+
+
+/*
+ * 带索引跳表层的链表实现.
+ * - 底层仍是linked_list, 迭代器类型与linked_list相同
+ * - 第k层的跳表节点指向一个链表节点, width为它到同层下一个跳表节点的距离,
+ *   同层最后一个跳表节点的width为它到尾后位置的距离, 每层的头节点指向before_head
+ * - 按下标的访问, 插入与删除为期望O(log n), 并同步维护跳表层
+ * - 通过迭代器的插入删除, 排序, 反转与合并等整体操作会丢弃跳表层(levels == 0),
+ *   在下一次非const的按下标访问时以O(n)重建
+ * - const的按下标访问不修改链表, 因此不会重建跳表层, 跳表层被丢弃时每次访问都从头遍历, 为O(n);
+ *   大量const访问之前可以先调用build_index()
+ * - 移动构造与移动赋值连同跳表层一起转移节点, 只有分配器不相等而逐个移动元素时才会丢弃跳表层
+ */
+template <typename T, typename AllocatorT = allocator<T>>
+class indexed_list: protected linked_list<T, AllocatorT> {
+
+	using base = linked_list<T, AllocatorT>;
+
+public:
+
+	using typename base::element_t;
+	using typename base::node_t;
+	using typename base::node_base_t;
+	using typename base::allocator_t;
+	using typename base::iterator;
+	using typename base::const_iterator;
+	using typename base::iterator_t;
+	using typename base::const_iterator_t;
+
+	static constexpr size_t max_levels = 16;
+
+protected:
+
+	struct lane_node {
+		node_base_t* target; //the list node, or &before_head for the lane heads
+		lane_node* next;
+		lane_node* down;     //the lane node of the same target on the lower level, nullptr on the lowest level
+		size_t width;        //the distance from target to next->target, or to the end if next == nullptr
+	};
+
+	using lane_allocator_t = typename allocator_traits<AllocatorT>::template rebind_alloc<lane_node>;
+	using lane_traits = allocator_traits<lane_allocator_t>;
+
+	using base::before_head;
+	using base::last;
+	using base::length;
+	using base::alloc;
+	using base::head;
+	using base::new_node;
+
+	lane_node lanes[max_levels];  //the heads of each level
+	size_t levels = 0;            //0 means the lanes are not built
+	std::uint64_t seed = 0x9e3779b97f4a7c15;
+	[[no_unique_address]] lane_allocator_t lane_alloc;
+
+public:
+
+	indexed_list() {init_lanes(); }
+	explicit indexed_list(const AllocatorT& alloc): base(alloc), lane_alloc(alloc) {init_lanes(); }
+	indexed_list(initializer_list<T> list, const AllocatorT& alloc = {}): base(list, alloc), lane_alloc(alloc) {init_lanes(); }
+	~indexed_list() {
+		drop_index();
+	}
+	indexed_list(const indexed_list& other): base(other), lane_alloc(base::get_allocator()) {init_lanes(); }
+	indexed_list(indexed_list&& other) noexcept: base(move(other)), lane_alloc(base::get_allocator()) {
+		init_lanes();
+		steal_index(other);
+	}
+	indexed_list& operator=(const indexed_list& other) {
+		if(this == &other) return *this;
+		drop_index();
+		base::operator=(other);
+		lane_alloc = lane_allocator_t(base::get_allocator());
+		return *this;
+	}
+	indexed_list& operator=(indexed_list&& other) noexcept(noexcept(std::declval<base&>() = std::declval<base&&>())) {
+		if(this == &other) return *this;
+		drop_index();
+		//the lanes go with the nodes, unless the elements are moved one by one for the unequal allocators
+		bool steals = lane_traits::propagate_on_container_move_assignment::value or lane_alloc == other.lane_alloc;
+		if(!steals) other.drop_index();
+		base::operator=(move(other));
+		lane_alloc = lane_allocator_t(base::get_allocator());
+		if(steals) steal_index(other);
+		return *this;
+	}
+
+	using base::size;
+	using base::get_allocator;
+	using base::front;
+	using base::back;
+	using base::before_begin;
+	using base::cbefore_begin;
+	using base::begin;
+	using base::end;
+	using base::cbegin;
+	using base::cend;
+	using base::is_empty;
+	using base::is_sorted;
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	indexed_list& push(U&& val) {
+		//O(log n)
+		return insert(length, forward<U>(val));
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	indexed_list& unshift(U&& val) {
+		return insert(0, forward<U>(val));
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	indexed_list& insert(size_t index, U&& val) {
+		//O(log n) expected, the same semantic as linked_list::insert()
+		if(index > length) index = length;
+		ensure_index();
+
+		lane_node*   update[max_levels];
+		size_t       update_pos[max_levels];
+		node_base_t* prev = find_update(index, update, update_pos);
+
+		//allocate everything before linking, so that a throwing allocation leaves the list unchanged
+		size_t height = random_level();
+		lane_node* tower[max_levels];
+		size_t allocated = 0;
+		node_t* node;
+		try {
+			for(; allocated < height; allocated++) tower[allocated] = lane_traits::allocate(lane_alloc, 1);
+			node = new_node(forward<U>(val), prev->next);
+		}catch(...) {
+			for(size_t k = 0; k < allocated; k++) lane_traits::deallocate(lane_alloc, tower[k], 1);
+			throw;
+		}
+
+		for(; levels < height; levels++) {
+			lanes[levels].next = nullptr;
+			lanes[levels].width = length + 1;
+			update[levels] = &lanes[levels];
+			update_pos[levels] = 0;
+		}
+		//the position of the new node, where before_head is at 0
+		size_t q = index + 1;
+		for(size_t k = 0; k < levels; k++) {
+			if(k < height) {
+				lane_traits::construct(lane_alloc, tower[k], lane_node{
+					node, update[k]->next, k == 0 ? nullptr : tower[k - 1],
+					update_pos[k] + update[k]->width + 1 - q
+				});
+				update[k]->next = tower[k];
+				update[k]->width = q - update_pos[k];
+			}else {
+				update[k]->width++;
+			}
+		}
+
+		prev->next = node;
+		if(prev == last) last = node;
+		length++;
+		return *this;
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	indexed_list& insert_after(iterator_t it, U&& val) {
+		//the position of it is unknown, so the lanes are dropped
+		drop_index();
+		base::insert_after(it, forward<U>(val));
+		return *this;
+	}
+
+	T& operator[](size_t index) {
+		//no boundary check, O(log n) expected
+		ensure_index();
+		return locate(index)->data;
+	}
+
+	const T& operator[](size_t index) const{
+		//no boundary check, O(log n) expected, but O(n) if the lanes are dropped, which are not rebuilt by the const access
+		return locate(index)->data;
+	}
+
+	T* get_ptr(size_t index) {
+		if(index >= length) return nullptr;
+		ensure_index();
+		return &(locate(index)->data);
+	}
+
+	const T* get_ptr(size_t index) const{
+		if(index >= length) return nullptr;
+		return &(locate(index)->data);
+	}
+
+	//O(n) if the lanes are dropped, so that the following const accesses are O(log n) expected
+	void build_index() {
+		ensure_index();
+	}
+
+	bool erase(size_t index) {
+		//returns whether erasing satisfied, O(log n) expected
+		if(index >= length) return false;
+		ensure_index();
+
+		lane_node*   update[max_levels];
+		size_t       update_pos[max_levels];
+		node_base_t* prev = find_update(index, update, update_pos);
+		node_t*      node = prev->next;
+		for(size_t k = 0; k < levels; k++) {
+			lane_node* l = update[k]->next;
+			if(l != nullptr and l->target == node) {
+				update[k]->width += l->width - 1;
+				update[k]->next = l->next;
+				delete_lane(l);
+			}else {
+				update[k]->width--;
+			}
+		}
+		while(levels > 1 and lanes[levels - 1].next == nullptr) levels--;
+		base::erase(&(prev->next));
+		return true;
+	}
+
+	void erase_after(iterator_t it) {
+		drop_index();
+		base::erase_after(it);
+	}
+
+	T shift() {
+		//no zero length check
+		T temp = move(front());
+		erase(0);
+		return temp;
+	}
+
+	T pop() {
+		//no zero length check
+		T temp = move(back());
+		erase(length - 1);
+		return temp;
+	}
+
+	void clear() {
+		drop_index();
+		base::clear();
+	}
+
+	void reverse() noexcept{
+		drop_index();
+		base::reverse();
+	}
+
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void merge(indexed_list&& other, const CompareT& comp = {}) {
+		if(this == &other) return;
+		drop_index();
+		other.drop_index();
+		base::merge(move(static_cast<base&>(other)), comp);
+	}
+
+	//the sorts relink every node, so the lanes are dropped and rebuilt on demand
+	template <typename... Args>
+	void sort(Args&&... args) {
+		drop_index();
+		base::sort(forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	void merge_sort(Args&&... args) {
+		drop_index();
+		base::merge_sort(forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	void natural_merge_sort(Args&&... args) {
+		drop_index();
+		base::natural_merge_sort(forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	void quick_sort(Args&&... args) {
+		drop_index();
+		base::quick_sort(forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	void radix_sort(Args&&... args) {
+		drop_index();
+		base::radix_sort(forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	void parallel_sort(Args&&... args) {
+		drop_index();
+		base::parallel_sort(forward<Args>(args)...);
+	}
+
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	iterator_t lower_bound(const T& val, const CompareT& comp = {}) {
+		//the first element which is not less than val, assume that the list is sorted by comp, O(log n) expected
+		ensure_index();
+		lane_node* x = &lanes[levels - 1];
+		for(size_t k = levels; k-- > 0; ) {
+			while(x->next != nullptr and comp(static_cast<node_t*>(x->next->target)->data, val)) x = x->next;
+			if(k != 0) x = x->down;
+		}
+		node_base_t* pos = x->target;
+		while(pos->next != nullptr and comp(pos->next->data, val)) pos = pos->next;
+		return {pos->next};
+	}
+
+	friend void swap(indexed_list& a, indexed_list& b) noexcept{
+		swap(static_cast<base&>(a), static_cast<base&>(b));
+		if constexpr(lane_traits::propagate_on_container_swap::value) {
+			using std::swap;
+			swap(a.lane_alloc, b.lane_alloc);
+		}
+		//only the lane heads belong to the containers
+		for(size_t k = 0; k < max_levels; k++) {
+			std::swap(a.lanes[k].next, b.lanes[k].next);
+			std::swap(a.lanes[k].width, b.lanes[k].width);
+		}
+		std::swap(a.levels, b.levels);
+	}
+
+	template <typename OutputStreamT> //such as std::ostream
+	requires requires(OutputStreamT& os, const base& list) {
+		{os << list}->same_as<OutputStreamT&>;
+	}
+	friend OutputStreamT& operator<<(OutputStreamT& os, const indexed_list& list) {
+		return os << static_cast<const base&>(list);
+	}
+
+protected:
+
+	void init_lanes() noexcept{
+		for(size_t k = 0; k < max_levels; k++) {
+			lanes[k] = lane_node{&before_head, nullptr, k == 0 ? nullptr : &lanes[k - 1], 0};
+		}
+	}
+
+	size_t random_level() noexcept{
+		//xorshift64, P(level >= k) = 1 / 4^k
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		return static_cast<size_t>(std::countr_zero(seed | (std::uint64_t{1} << (2 * max_levels)))) / 2;
+	}
+
+	void delete_lane(lane_node* l) noexcept{
+		lane_traits::destroy(lane_alloc, l);
+		lane_traits::deallocate(lane_alloc, l, 1);
+	}
+
+	void drop_index() noexcept{
+		for(size_t k = 0; k < levels; k++) {
+			lane_node* l = lanes[k].next;
+			while(l != nullptr) {
+				lane_node* temp = l->next;
+				delete_lane(l);
+				l = temp;
+			}
+			lanes[k].next = nullptr;
+		}
+		levels = 0;
+	}
+
+	void steal_index(indexed_list& other) noexcept{
+		//assume that the lanes of *this are dropped, and the nodes of other are stolen by *this
+		for(size_t k = 0; k < other.levels; k++) {
+			lanes[k].next = other.lanes[k].next;
+			lanes[k].width = other.lanes[k].width;
+			other.lanes[k].next = nullptr;
+		}
+		levels = other.levels;
+		other.levels = 0;
+	}
+
+	void ensure_index() {
+		//O(n), build the lanes if they are dropped
+		if(levels != 0) return;
+		lane_node* tails[max_levels];
+		size_t     tail_pos[max_levels];
+		for(size_t k = 0; k < max_levels; k++) {
+			tails[k] = &lanes[k];
+			tail_pos[k] = 0;
+		}
+		size_t height_max = 1;
+		try {
+			size_t p = 1;
+			for(node_t* pos = head(); pos != nullptr; pos = pos->next, p++) {
+				size_t height = random_level();
+				for(size_t k = 0; k < height; k++) {
+					lane_node* l = lane_traits::allocate(lane_alloc, 1);
+					lane_traits::construct(lane_alloc, l, lane_node{pos, nullptr, k == 0 ? nullptr : tails[k - 1], 0});
+					tails[k]->next = l;
+					tails[k]->width = p - tail_pos[k];
+					tails[k] = l;
+					tail_pos[k] = p;
+					//levels keeps the built levels, so that drop_index() can clean them up
+					if(k + 1 > levels) levels = k + 1;
+				}
+				if(height > height_max) height_max = height;
+			}
+		}catch(...) {
+			drop_index();
+			throw;
+		}
+		levels = height_max;
+		for(size_t k = 0; k < levels; k++) tails[k]->width = length + 1 - tail_pos[k];
+	}
+
+	node_base_t* find_update(size_t index, lane_node** update, size_t* update_pos) noexcept{
+		//find the last lane node before the index-th node on each level,
+		//returns the node (or &before_head) in front of the index-th node
+		size_t q = index + 1,
+		       pos = 0;
+		lane_node* x = &lanes[levels - 1];
+		for(size_t k = levels; k-- > 0; ) {
+			while(x->next != nullptr and pos + x->width < q) {
+				pos += x->width;
+				x = x->next;
+			}
+			update[k] = x;
+			update_pos[k] = pos;
+			if(k != 0) x = x->down;
+		}
+		node_base_t* prev = x->target;
+		for(; pos < index; pos++) prev = prev->next;
+		return prev;
+	}
+
+	node_t* locate(size_t index) const noexcept{
+		//the index-th node, walks from the head if the lanes are dropped
+		size_t q = index + 1,
+		       pos = 0;
+		const node_base_t* target = &before_head;
+		if(levels != 0) {
+			const lane_node* x = &lanes[levels - 1];
+			for(size_t k = levels; k-- > 0; ) {
+				while(x->next != nullptr and pos + x->width <= q) {
+					pos += x->width;
+					x = x->next;
+				}
+				if(k != 0) x = x->down;
+			}
+			target = x->target;
+		}
+		for(; pos < q; pos++) target = target->next;
+		return static_cast<node_t*>(const_cast<node_base_t*>(target));
+	}
+
+}; //class indexed_list<T, AllocatorT>
+
+
+} //namespace rais::study
@@ -0,0 +1,328 @@
+#pragma once
+
+//侵入式双向链表实现
+
+#include <bit>
+#include <cstddef>
+#include <utility>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+
+namespace rais::study {
+
+using std::size_t;
+using std::less;
+using std::less_equal;
+
+//concepts
+using std::same_as;
+using std::predicate;
+
+//the links embedded in the user's object, an object can belong to several lists through several hooks
+struct double_hook {
+	double_hook* priv = nullptr, //point to privious hook, nullptr if it's not linked
+	           * next = nullptr; //point to next hook
+
+	double_hook() noexcept{}
+	//copying an object does not copy its membership
+	double_hook(const double_hook&) noexcept{}
+	double_hook& operator=(const double_hook&) noexcept{return *this; }
+
+	bool is_linked() const noexcept{return priv != nullptr; }
+};
+
+
+/*
+ * 侵入式双链表实现.
+ * - 链接存放在用户对象的double_hook成员Hook中, 链表不拥有也不分配对象, push与erase不会分配内存
+ * - 一个对象可以通过多个hook成员同时属于多个链表, 同一个hook同一时间只能属于一个链表
+ * - 与double_list相同, 链表为空时head == nullptr, 不为空时head->priv == tail, tail->next == nullptr
+ * - 未链接的hook的priv == nullptr, 因此可以从对象的引用O(1)地判断并解除链接
+ * - 链表析构或clear()时只解除链接, 对象的生命周期由用户管理, 对象析构前应先从链表中移除
+ */
+template <typename T, double_hook T::* Hook>
+class intrusive_double_list {
+
+public:
+
+	using element_t = T;
+	using hook_t = double_hook;
+
+	struct iterator {
+	private:
+		hook_t* it;
+
+	public:
+		iterator(hook_t* it): it{it} {}
+		T& operator*() const{return owner_of(it); }
+		T* operator->() const noexcept{return &owner_of(it); }
+		iterator& operator++() {it = it->next; return *this;}
+		iterator operator++(int) {auto temp = iterator{it}; it = it->next; return temp;}
+		iterator& operator--() {it = it->priv; return *this;}
+		iterator operator--(int) {auto temp = iterator{it}; it = it->priv; return temp;}
+		bool operator==(const iterator& other) const noexcept{return it == other.it; }
+		bool operator!=(const iterator& other) const noexcept{return it != other.it; }
+
+		hook_t* get_ptr() noexcept{return it; }
+		const hook_t* get_ptr() const noexcept{return it; }
+	};
+
+	struct const_iterator {
+	private:
+		const hook_t* it;
+
+	public:
+		const_iterator(const hook_t* it): it{it} {}
+		const T& operator*() const{return owner_of(it); }
+		const T* operator->() const noexcept{return &owner_of(it); }
+		const_iterator& operator++() {it = it->next; return *this;}
+		const_iterator operator++(int) {auto temp = const_iterator{it}; it = it->next; return temp;}
+		const_iterator& operator--() {it = it->priv; return *this;}
+		const_iterator operator--(int) {auto temp = const_iterator{it}; it = it->priv; return temp;}
+		bool operator==(const const_iterator& other) const noexcept{return it == other.it; }
+		bool operator!=(const const_iterator& other) const noexcept{return it != other.it; }
+
+		const hook_t* get_ptr() const noexcept{return it; }
+	};
+	using iterator_t = iterator;
+	using const_iterator_t = const_iterator;
+
+protected:
+
+	hook_t* head = nullptr;
+	size_t len = 0;
+
+public:
+
+	intrusive_double_list() {}
+	//the objects can not be copied into another list without copying the objects
+	intrusive_double_list(const intrusive_double_list&) = delete;
+	intrusive_double_list& operator=(const intrusive_double_list&) = delete;
+	intrusive_double_list(intrusive_double_list&& other) noexcept: head{other.head}, len{other.len} {
+		other.head = nullptr;
+		other.len = 0;
+	}
+	intrusive_double_list& operator=(intrusive_double_list&& other) noexcept{
+		if(this == &other) return *this;
+		clear();
+		head = other.head;
+		len = other.len;
+		other.head = nullptr;
+		other.len = 0;
+		return *this;
+	}
+	~intrusive_double_list() {
+		clear();
+	}
+
+	size_t length() const noexcept{ return len; }
+	size_t size() const noexcept{ return len; }
+
+	//no zero length check
+	T& front() {return owner_of(head); }
+	const T& front() const{return owner_of(head); }
+	T& back() {return owner_of(head->priv); }
+	const T& back() const{return owner_of(head->priv); }
+
+	iterator_t begin()              noexcept{return {head};    }
+	iterator_t end()                noexcept{return {nullptr}; }
+	const_iterator_t begin()  const noexcept{return {head};    }
+	const_iterator_t end()    const noexcept{return {nullptr}; }
+	const_iterator_t cbegin() const noexcept{return {head};    }
+	const_iterator_t cend()   const noexcept{return {nullptr}; }
+
+	bool is_empty() const noexcept{return !head; }
+
+	//O(1), the iterator of an object which is linked in this list
+	static iterator_t iterator_to(T& obj) noexcept{return {&(obj.*Hook)}; }
+	static const_iterator_t iterator_to(const T& obj) noexcept{return {&(obj.*Hook)}; }
+
+	//the hook of obj should not be linked, no check
+	intrusive_double_list& push(T& obj) noexcept{
+		hook_t* hook = &(obj.*Hook);
+		if(!head) {
+			head = hook;
+			head->priv = head;
+			head->next = nullptr;
+		}else {
+			hook_t* tail = head->priv;
+			hook->priv = tail;
+			hook->next = nullptr;
+			head->priv = tail->next = hook;
+		}
+		len++;
+		return *this;
+	}
+
+	intrusive_double_list& unshift(T& obj) noexcept{
+		hook_t* hook = &(obj.*Hook);
+		if(!head) {
+			hook->priv = hook;
+			hook->next = nullptr;
+		}else {
+			hook->priv = head->priv;
+			hook->next = head;
+			head->priv = hook;
+		}
+		head = hook;
+		len++;
+		return *this;
+	}
+
+	//link obj in front of it
+	intrusive_double_list& insert(iterator_t it, T& obj) noexcept{
+		if(it.get_ptr() == head) return unshift(obj);
+		if(it.get_ptr() == nullptr) return push(obj);
+
+		hook_t* hook = &(obj.*Hook),
+		      * pos = it.get_ptr();
+		hook->priv = pos->priv;
+		hook->next = pos;
+		pos->priv = pos->priv->next = hook;
+		len++;
+		return *this;
+	}
+
+	T& operator[](size_t index) {
+		return const_cast<T&>(static_cast<const intrusive_double_list&>(*this)[index]);
+	}
+	const T& operator[](size_t index) const{
+		//no zero length and boundary check, O(n)
+		const hook_t* pos = head;
+		if(index <= len / 2) {
+			for(size_t i = 0; i < index; i++) pos = pos->next;
+		}else {
+			for(size_t i = 0; i < (len - index); i++) pos = pos->priv;
+		}
+		return owner_of(pos);
+	}
+
+	T& shift() noexcept{
+		//no zero length check, returns the unlinked object
+		T& obj = front();
+		unlink(head);
+		return obj;
+	}
+
+	T& pop() noexcept{
+		//no zero length check, returns the unlinked object
+		T& obj = back();
+		unlink(head->priv);
+		return obj;
+	}
+
+	void erase(iterator_t it) noexcept{
+		unlink(it.get_ptr());
+	}
+
+	//O(1), the hook of obj should be linked in this list, no check
+	void erase(T& obj) noexcept{
+		unlink(&(obj.*Hook));
+	}
+
+	void clear() noexcept{
+		//only unlinks the objects
+		hook_t* pos = head;
+		while(pos != nullptr) {
+			hook_t* temp = pos->next;
+			pos->priv = pos->next = nullptr;
+			pos = temp;
+		}
+		head = nullptr;
+		len = 0;
+	}
+
+	void reverse() noexcept{
+		if(len <= 1) return;
+
+		hook_t* pos = head;
+		do {
+			//swap pos->priv and pos->next
+			hook_t* temp = pos->priv;
+			pos->priv = pos->next;
+			pos->next = temp;
+			pos = pos->priv; //point to next hook, exectly
+		}while(pos->next != nullptr);
+		pos->next = pos->priv;
+		pos->priv = head;
+		head->next = nullptr;
+		head = pos;
+	}
+
+	template <typename CompareT = less_equal<T>> //where CompareT should be less_equal<T> to match less<T>{}
+	requires predicate<CompareT, T, T>
+	bool is_sorted(const CompareT& comp = {}) const{
+		if(head == nullptr) return true;
+		for(const hook_t* pos = head; pos->next != nullptr; pos = pos->next) {
+			if( !comp(owner_of(pos), owner_of(pos->next)) ) return false;
+		}
+		return true;
+	}
+
+	friend void swap(intrusive_double_list& a, intrusive_double_list& b) noexcept{
+		hook_t* temp_head = a.head;
+		size_t temp_len = a.len;
+		a.head = b.head;
+		a.len = b.len;
+		b.head = temp_head;
+		b.len = temp_len;
+	}
+
+	template <typename OutputStreamT>
+	requires requires(OutputStreamT& os, const T& val, char c, const char* s) {
+		{os << val}->same_as<OutputStreamT&>;
+		{os << c}->same_as<OutputStreamT&>;
+		{os << s}->same_as<OutputStreamT&>;
+	}
+	friend OutputStreamT& operator<<(OutputStreamT& os, const intrusive_double_list& list) {
+		os << '[';
+		if(list.size() != 0) {
+			os << *list.cbegin();
+			for(auto it = ++list.cbegin(); it != list.cend(); ++it) {
+				os << ", " << *it;
+			}
+		}
+		return os << ']';
+	}
+
+protected:
+
+	static T& owner_of(hook_t* hook) noexcept{
+		return *reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - hook_offset());
+	}
+	static const T& owner_of(const hook_t* hook) noexcept{
+		return *reinterpret_cast<const T*>(reinterpret_cast<const char*>(hook) - hook_offset());
+	}
+	//a data member pointer is represented as the offset of the member in the Itanium C++ ABI (GCC, Clang) and in the MSVC ABI,
+	//the pointers of the classes with virtual bases are larger on MSVC, which fail the size check
+	using hook_offset_t = std::conditional_t<sizeof(Hook) == sizeof(std::ptrdiff_t), std::ptrdiff_t, int>;
+	static_assert(sizeof(Hook) == sizeof(hook_offset_t), "the member pointer does not hold a plain offset");
+
+	static std::ptrdiff_t hook_offset() noexcept{
+		//the offset of the Hook member in T, like offsetof(T, hook), read from Hook without any object of T,
+		//which is folded into a constant
+		return std::bit_cast<hook_offset_t>(Hook);
+	}
+
+	void unlink(hook_t* hook) noexcept{
+		if(hook == head) {
+			//unlink head hook
+			head = hook->next;
+			if(head != nullptr) head->priv = hook->priv;
+		}else if(hook->next == nullptr) {
+			//unlink tail hook
+			hook->priv->next = nullptr;
+			head->priv = hook->priv;
+		}else {
+			hook->priv->next = hook->next;
+			hook->next->priv = hook->priv;
+		}
+		hook->priv = hook->next = nullptr;
+		len--;
+	}
+
+}; //class intrusive_double_list<T, Hook>
+
+
+} //namespace rais::study
@@ -1,13 +1,25 @@
 #pragma once
 
+#include <bit>
 #include <limits>
+#include <memory>
+#include <ranges>
+#include <thread>
+#include <vector>
+#include <iterator>
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <concepts>
 #include <functional>
 #include <type_traits>
 #include <initializer_list>
 
+#include <prefetch.hpp>
+#include <node_blocks.hpp>
+#include <node_handle.hpp>
+
 namespace rais::study {
 
 using std::size_t;
@@ -17,158 +29,195 @@ using std::less;
 using std::less_equal;
 using std::forward;
 using std::move;
+using std::allocator;
+using std::allocator_traits;
 
 //concepts
 using std::same_as;
 using std::predicate;
 using std::convertible_to;
 
+//the key type of linked_list::radix_sort()
+template <typename KeyT>
+concept radix_key = std::integral<std::remove_cvref_t<KeyT>> and !same_as<std::remove_cvref_t<KeyT>, bool>;
+
+
+//policy tags of linked_list::sort()
+namespace sort_policy {
+	struct quick_t {};
+	struct merge_t {};
+	struct natural_t {};
+	struct gather_t {};
+
+	inline constexpr quick_t   quick{};
+	inline constexpr merge_t   merge{};
+	inline constexpr natural_t natural{};
+	inline constexpr gather_t  gather{};
+} //namespace sort_policy
+
+template <typename T>
+struct list_node;
+
+//only holds the link, so that the list can keep a sentinel before the first node, 
+//a node_t** that points to some 'next' member can also be converted back to its owner
+template <typename T>
+struct list_node_base {
+	list_node<T>* next;
+};
 
 template <typename T>
-struct list_node {
+struct list_node: list_node_base<T> {
 	T data;
-	list_node* next;
 
 	template <typename U> 
 	requires convertible_to<U, const T&>
-	list_node(U&& val, list_node* next): data(forward<U>(val)), next(next) {}
+	list_node(U&& val, list_node* next): list_node_base<T>{next}, data(forward<U>(val)) {}
 	template <typename U>
 	requires convertible_to<U, const T&>
 	list_node(U&& val): data(forward<U>(val)) {}
 };
 
-template <typename T>
+template <typename T, typename AllocatorT = allocator<T>, typename PrefetchT = prefetch_policy::none>
+requires prefetch_policy_type<PrefetchT>
 class linked_list {
 public:
 
 	using element_t = T;
 	using node_t = list_node<T>;
+	using node_base_t = list_node_base<T>;
+	using allocator_t = AllocatorT;
+	using prefetch_t = PrefetchT;
+	using node_allocator_t = typename allocator_traits<AllocatorT>::template rebind_alloc<node_t>;
+	using node_traits = allocator_traits<node_allocator_t>;
+	using node_handle_t = node_handle<node_t, node_allocator_t>;
 
 	struct iterator {
 	private:
-		node_t* it;
+		node_base_t* it;
 
 	public:
-		iterator(node_t* it): it{it} {}
-		T& operator*() {return it->data; }
-		const T& operator*() const{ return it->data; }
-		T* operator->() noexcept{return &(it->data); } 
-		const T* operator->() const noexcept{return &(it->data); }
+		iterator(node_base_t* it): it{it} {}
+		T& operator*() {return static_cast<node_t*>(it)->data; }
+		const T& operator*() const{ return static_cast<const node_t*>(it)->data; }
+		T* operator->() noexcept{return &(static_cast<node_t*>(it)->data); } 
+		const T* operator->() const noexcept{return &(static_cast<const node_t*>(it)->data); }
 		iterator& operator++() {it = it->next; return *this;}
 		iterator operator++(int) {auto temp = iterator{it}; it = it->next; return temp;}
 		bool operator==(const iterator& other) const noexcept{return it == other.it; }
 		bool operator!=(const iterator& other) const noexcept{return it != other.it; }
 
-		node_t* get_ptr() noexcept{return it; }
-		const node_t* get_ptr() const noexcept{return it; }
+		//it might be the sentinel of before_begin(), so only the 'next' member is accessible
+		node_base_t* get_ptr() noexcept{return it; }
+		const node_base_t* get_ptr() const noexcept{return it; }
 	};
 
 	struct const_iterator{
 	private:
-		const node_t* it;
+		const node_base_t* it;
 
 	public:
-		const_iterator(const node_t* it): it{it} {}
-		const T& operator*() const{ return it->data; }
-		const T* operator->() const noexcept{return &(it->data); }
+		const_iterator(const node_base_t* it): it{it} {}
+		const T& operator*() const{ return static_cast<const node_t*>(it)->data; }
+		const T* operator->() const noexcept{return &(static_cast<const node_t*>(it)->data); }
 		const_iterator& operator++() {it = it->next; return *this;}
 		const_iterator operator++(int) {auto temp = const_iterator{it}; it = it->next; return temp;}
 		bool operator==(const const_iterator& other) const noexcept{return it == other.it; }
 		bool operator!=(const const_iterator& other) const noexcept{return it != other.it; }
 
-		const node_t* get_ptr() const noexcept{return it; }
+		const node_base_t* get_ptr() const noexcept{return it; }
 	};
 	using iterator_t = iterator;
 	using const_iterator_t = const_iterator;
 
 protected:
 
-	node_t* head = nullptr;
+	node_base_t before_head{nullptr};  //before_head.next is the first node
+	node_base_t* last = &before_head;  //the last node, or &before_head if the list is empty
 	size_t length = 0;
+	[[no_unique_address]] node_allocator_t alloc;
+	node_blocks<node_t, node_allocator_t> blocks; //the nodes of the batch operations
 
 public:
 	linked_list() {}
-	linked_list(initializer_list<T> list) {
-		node_t** pos = &head;
-		for(const auto& i: list) {
-			*pos = new node_t{i};
-			pos = &((*pos)->next);
-		}
-		*pos = nullptr;
-		length = list.size();
+	explicit linked_list(const AllocatorT& alloc): alloc(alloc) {}
+	linked_list(initializer_list<T> list, const AllocatorT& alloc = {}): alloc(alloc) {
+		build([&] {append_n(list.begin(), list.size()); });
+	}
+	template <std::input_iterator IteratorT, std::sentinel_for<IteratorT> SentinelT>
+	requires convertible_to<std::iter_reference_t<IteratorT>, const T&>
+	linked_list(IteratorT first, SentinelT sentinel, const AllocatorT& alloc = {}): alloc(alloc) {
+		build([&] {append(move(first), move(sentinel)); });
 	}
 	~linked_list() {
 		clear();
 	}
-	linked_list(const linked_list& other) {
-		//copy constructor
-		node_t** pps = &head,      //point to a pointer that point to self
-		       * po  = other.head; //point other 
-		while(po != nullptr) {
-			*pps = new node_t{po->data/* copy */, nullptr};
-			pps = &((*pps)->next);
-			po = po->next;
-		}
-		length = other.length;
+	linked_list(const linked_list& other): alloc(node_traits::select_on_container_copy_construction(other.alloc)) {
+		//copy constructor, the nodes are allocated in one block
+		build([&] {append_n(other.cbegin(), other.length); });
 	}
-	linked_list(linked_list&& other) noexcept: head{other.head}, length{other.length} {
+	linked_list(linked_list&& other) noexcept: alloc(move(other.alloc)) {
 		//move constructor
-		other.head = nullptr;
-		other.length = 0;
+		steal(other);
+		blocks.adopt(other.blocks);
 	}
 	linked_list& operator=(const linked_list& other) {
-		//copy assignment
+		//copy assignment, reuses the nodes of *this, only the difference of length is allocated or deallocated
 		if(this == &other) return *this;
-		clear();
-		node_t** pps = &head,      //point to a pointer that point to self
-		       * po  = other.head; //point other 
-		while(po != nullptr) {
-			*pps = new node_t{po->data/* copy */, nullptr};
-			pps = &((*pps)->next);
-			po = po->next;
+		if constexpr(node_traits::propagate_on_container_copy_assignment::value) {
+			//the nodes can not be deallocated by the new allocator
+			if(alloc != other.alloc) clear();
+			alloc = other.alloc;
 		}
-		length = other.length;
+		assign_n(other.cbegin(), other.length);
 		return *this;
 	}
-	linked_list& operator=(linked_list&& other) noexcept{
+	linked_list& operator=(linked_list&& other) noexcept(node_traits::propagate_on_container_move_assignment::value or node_traits::is_always_equal::value) {
 		//move assignment
 		if(this == &other) return *this;
 		clear();
-		head = other.head;
-		length = other.length;
-		other.head = nullptr;
-		other.length = 0;
+		if constexpr(node_traits::propagate_on_container_move_assignment::value) {
+			alloc = move(other.alloc);
+		}else if(alloc != other.alloc) {
+			//the nodes of other can not be deallocated by alloc, move the elements one by one
+			for(auto& i: other) push(move(i));
+			other.clear();
+			return *this;
+		}
+		steal(other);
+		blocks.adopt(other.blocks);
 		return *this;
 	}
 
 	size_t size() const noexcept{return length; }
 
+	allocator_t get_allocator() const noexcept{return allocator_t(alloc); }
+
 	//no zero length check
-	T& front() {return head->data; }
-	const T& front() const{return head->data; }
+	T& front() {return head()->data; }
+	const T& front() const{return head()->data; }
 	T& back() {return tail()->data; }
 	const T& back() const{return tail()->data; }
 
 
-	iterator_t begin()              noexcept{return {head};    }
+	iterator_t before_begin()              noexcept{return {&before_head}; }
+	const_iterator_t before_begin()  const noexcept{return {&before_head}; }
+	const_iterator_t cbefore_begin() const noexcept{return {&before_head}; }
+	iterator_t begin()              noexcept{return {head()};  }
 	iterator_t end()                noexcept{return {nullptr}; }
-	const_iterator_t begin()  const noexcept{return {head};    }
+	const_iterator_t begin()  const noexcept{return {head()};  }
 	const_iterator_t end()    const noexcept{return {nullptr}; }
-	const_iterator_t cbegin() const noexcept{return {head};    }
+	const_iterator_t cbegin() const noexcept{return {head()};  }
 	const_iterator_t cend()   const noexcept{return {nullptr}; }
 
-	bool is_empty() const noexcept{return !head; }
+	bool is_empty() const noexcept{return !head(); }
 
 
 	template <typename U> 
 	requires convertible_to<U, const T&>
 	linked_list& push(U&& val) {
-		auto pos = tail();
-		if(!pos) head = new node_t{forward<U>(val), nullptr};
-		else {
-			//where tail != nullptr
-			pos->next = new node_t{forward<U>(val), nullptr};
-		}
+		//O(1), last is &before_head when the list is empty
+		last->next = new_node(forward<U>(val), nullptr);
+		last = last->next;
 		length++;
 		return *this;
 	}
@@ -176,7 +225,8 @@ public:
 	template <typename U>
 	requires convertible_to<U, const T&>
 	linked_list& unshift(U&& val) {
-		head = new node_t{forward<U>(val), head};
+		head() = new_node(forward<U>(val), head());
+		if(length == 0) last = head();
 		length++;
 		return *this;
 	}
@@ -186,10 +236,9 @@ public:
 	linked_list& insert(size_t index, U&& val)  {
 		//the param index will be param val's new index of list, 
 		//the previous element of the index will be shift to the next of the new element.
-		if(index > length) index = length;
-		node_t** pos = &head;
-		for(size_t i = 0; i < index; i++) pos = &((*pos)->next);
-		*pos = new node_t{forward<U>(val), *pos};
+		if(index >= length) return push(forward<U>(val));
+		node_t** pos = next_n<false>(&head(), index);
+		*pos = new_node(forward<U>(val), *pos);
 		length++;
 		return *this;
 	}
@@ -197,39 +246,77 @@ public:
 	template <typename U>
 	requires convertible_to<U, const T&>
 	linked_list& insert_after(iterator_t it, U&& val) {
-		//insert val after the data that it points
-		//no before_begin() / before_cbegin() method, 
-		//it means it's impossible to insert a element to the head
+		//insert val after the data that it points, 
+		//it might be before_begin(), which means inserting to the head
 		//no iterator validity check
-		it.get_ptr()->next = new node_t{*it, it.get_ptr()->next};
+		node_base_t* pos = it.get_ptr();
+		pos->next = new_node(forward<U>(val), pos->next);
+		if(pos == last) last = pos->next;
 		length++;
 		return *this;
 	}
 
+	//replaces the elements, the existing nodes are reused, the extra nodes are allocated in one block
+	template <std::input_iterator IteratorT, std::sentinel_for<IteratorT> SentinelT>
+	requires convertible_to<std::iter_reference_t<IteratorT>, const T&>
+	linked_list& assign(IteratorT first, SentinelT sentinel) {
+		if constexpr(std::forward_iterator<IteratorT>) {
+			size_t n = static_cast<size_t>(std::ranges::distance(first, sentinel));
+			assign_n(move(first), n);
+		}else {
+			node_t** pos = &head();
+			size_t n = 0;
+			for(; *pos != nullptr and first != sentinel; ++first, n++) {
+				(*pos)->data = *first;
+				pos = &((*pos)->next);
+			}
+			if(*pos != nullptr) erase_from(pos, n);
+			else append(move(first), move(sentinel));
+		}
+		return *this;
+	}
+
+	linked_list& assign(initializer_list<T> list) {
+		assign_n(list.begin(), list.size());
+		return *this;
+	}
+
+	//push the elements of range, the nodes are allocated in one block if the range is a forward range
+	template <std::ranges::input_range RangeT>
+	requires convertible_to<std::ranges::range_reference_t<RangeT>, const T&>
+	linked_list& append_range(RangeT&& range) {
+		if constexpr(std::ranges::sized_range<RangeT>) {
+			append_n(std::ranges::begin(range), static_cast<size_t>(std::ranges::size(range)));
+		}else {
+			append(std::ranges::begin(range), std::ranges::end(range));
+		}
+		return *this;
+	}
+
 	T& operator[](size_t index) {
 		//no boundary check
-		node_t* pos = head;
+		node_t* pos = head();
 		for(size_t i = 0; i < index; i++) pos = pos->next;
 		return pos->data;
 	}
 
 	const T& operator[](size_t index) const{
 		//no boundary check
-		const node_t* pos = head;
+		const node_t* pos = head();
 		for(size_t i = 0; i < index; i++) pos = pos->next;
 		return pos->data;
 	}
 
 	T* get_ptr(size_t index) {
 		if(index >= length) return nullptr;
-		node_t* pos = head;
+		node_t* pos = head();
 		for(size_t i = 0; i < index; i++) pos = pos->next;
 		return &(pos->data);
 	}
 
 	const T* get_ptr(size_t index) const{
 		if(index >= length) return nullptr;
-		node_t* pos = head;
+		const node_t* pos = head();
 		for(size_t i = 0; i < index; i++) pos = pos->next;
 		return &(pos->data);
 	}
@@ -237,72 +324,208 @@ public:
 	bool erase(size_t index) {
 		//returns whether erasing satisfied
 		if(index >= length) return false;
-		node_t** pos = &head;
-		for(size_t i = 0; i < index; i++) pos = &((*pos)->next);
-		node_t* temp = (*pos)->next;
-		delete *pos;
-		*pos = temp;
-		length--;
+		erase(next_n<false>(&head(), index));
 		return true;
 	}
 
 
 	void erase_after(iterator_t it) {
-		//no before_begin() / before_cbegin() method, 
-		//it means it's impossible to erase a element of the head
+		//it might be before_begin(), which means erasing the head
 		//no iterator validity check, therefore it's useless to return whether the operation is satisfied.
-		node_t* afters = it.get_ptr()->next->next;
-		delete it.get_ptr()->next;
-		it.get_ptr()->next = afters;
-		length--;
+		erase(&(it.get_ptr()->next));
 	}	
 
+	//O(index), takes the node out of the list without deallocating it, 
+	//the handle is empty if index is out of range
+	node_handle_t extract(size_t index) noexcept{
+		if(index >= length) return {};
+		return {detach(next_n<false>(&head(), index)), alloc, blocks};
+	}
+
+	//O(1), takes the node after it, where it might be before_begin(), 
+	//the handle is empty if it is the last node
+	node_handle_t extract_after(iterator_t it) noexcept{
+		node_t* node = detach(&(it.get_ptr()->next));
+		if(node == nullptr) return {};
+		return {node, alloc, blocks};
+	}
+
+	//the node of handle is linked without allocating, nothing happens if handle is empty,
+	//handle's allocator should be equal to this one's
+	linked_list& push(node_handle_t&& handle) noexcept{
+		link_after(last, handle);
+		return *this;
+	}
+
+	linked_list& unshift(node_handle_t&& handle) noexcept{
+		link_after(&before_head, handle);
+		return *this;
+	}
+
+	linked_list& insert(size_t index, node_handle_t&& handle) noexcept{
+		if(index >= length) return push(move(handle));
+		link_after(base_of(next_n<false>(&head(), index)), handle);
+		return *this;
+	}
+
+	linked_list& insert_after(iterator_t it, node_handle_t&& handle) noexcept{
+		link_after(it.get_ptr(), handle);
+		return *this;
+	}
+
+	//move the nodes (before_first, last_it) of other after pos, without allocating.
+	//O(distance(before_first, last_it)) to find the last node of the range, 
+	//pos should not be in the range, no allocator equality check like merge()
+	void splice_after(iterator_t pos, linked_list& other, iterator_t before_first, iterator_t last_it) noexcept{
+		node_base_t* p = pos.get_ptr(),
+		           * before = before_first.get_ptr();
+		node_t* first = before->next,
+		      * end = static_cast<node_t*>(last_it.get_ptr());
+		//moving a range after the node in front of it changes nothing
+		if(first == end or p == before) return;
+		node_base_t* range_last = before;
+		size_t n = 0;
+		for(; range_last->next != end; n++) range_last = range_last->next;
+
+		before->next = end;
+		if(range_last == other.last) other.last = before;
+		range_last->next = p->next;
+		p->next = first;
+		if(p == last) last = range_last;
+		if(&other != this) {
+			other.length -= n;
+			length += n;
+			blocks.share(other.blocks);
+		}
+	}
+
+	//O(1), move the node after it of other after pos
+	void splice_after(iterator_t pos, linked_list& other, iterator_t it) noexcept{
+		//moving a node after itself or the node in front of it changes nothing
+		if(pos == it or pos.get_ptr() == it.get_ptr()->next) return;
+		node_handle_t handle = other.extract_after(it);
+		link_after(pos.get_ptr(), handle);
+	}
+
+	//O(1), move all the nodes of other after pos
+	void splice_after(iterator_t pos, linked_list& other) noexcept{
+		if(&other == this or other.is_empty()) return;
+		node_base_t* p = pos.get_ptr();
+		other.last->next = p->next;
+		p->next = other.head();
+		if(p == last) last = other.last;
+		length += other.length;
+		other.head() = nullptr;
+		other.last = &other.before_head;
+		other.length = 0;
+		blocks.share(other.blocks);
+	}
+
 	T shift() {
 		//no zero length check
-		T temp = move(head->data);
-		node_t* old_head = head;
-		head = head->next;
-		delete old_head;
+		T temp = move(head()->data);
+		node_t* old_head = head();
+		head() = old_head->next;
+		if(old_head == last) last = &before_head;
+		delete_node(old_head);
 		length--;
 		return temp;
 	}
 
 	T pop() {
 		//no zero length check
-		node_t** pos = &head;
+		node_t** pos = &head();
 		while((*pos)->next != nullptr) pos = &((*pos)->next);
 		T temp = move((*pos)->data);
-		delete *pos;
+		delete_node(*pos);
 		*pos = nullptr;
+		last = base_of(pos);
 		length--;
 		return temp;
 	}
 
 	void clear() {
-		if(!head) return;
-		node_t* pos = head;
+		node_t* pos = head();
+		prefetcher_t prefetcher{pos};
 		while(pos != nullptr) {
 			node_t* temp = pos->next;
-			delete pos;
+			prefetcher.step();
+			delete_node(pos);
 			pos = temp;
 		}
-		head = nullptr;
+		head() = nullptr;
+		last = &before_head;
 		length = 0;
+		blocks.release(alloc);
+	}
+
+	//moves the elements into one new block in list order and relinks them, to restore the memory locality after churn.
+	//invalidates the iterators and references, the elements are copied if their move constructor might throw.
+	//returns the bytes of the deallocated nodes minus the allocated ones, which is negative if the old blocks
+	//are still shared by other lists, the overhead of the allocator for each allocation is not counted
+	std::ptrdiff_t relayout() {
+		if(length == 0) return 0;
+		node_blocks<node_t, node_allocator_t> fresh;
+		node_t* block = nullptr;
+		size_t i = 0;
+		try {
+			block = fresh.allocate(alloc, length);
+			for(node_t* pos = head(); pos != nullptr; pos = pos->next, i++) {
+				node_traits::construct(alloc, block + i, std::move_if_noexcept(pos->data), block + i + 1);
+			}
+		}catch(...) {
+			while(i != 0) node_traits::destroy(alloc, block + --i);
+			fresh.release(alloc);
+			throw;
+		}
+		block[length - 1].next = nullptr;
+
+		size_t freed = 0;
+		for(node_t* pos = head(); pos != nullptr; ) {
+			node_t* temp = pos->next;
+			node_traits::destroy(alloc, pos);
+			if(!blocks.put(pos)) {
+				node_traits::deallocate(alloc, pos, 1);
+				freed += sizeof(node_t);
+			}
+			pos = temp;
+		}
+		freed += blocks.release(alloc);
+		blocks.adopt(fresh);
+		head() = block;
+		last = block + length - 1;
+		return static_cast<std::ptrdiff_t>(freed) - static_cast<std::ptrdiff_t>(length * sizeof(node_t));
+	}
+
+	//the average distance in bytes between the addresses of the adjacent nodes, O(n),
+	//it's sizeof(node_t) after relayout(), and grows as the nodes are scattered
+	double average_stride() const noexcept{
+		if(length < 2) return 0;
+		double sum = 0;
+		for(const node_t* pos = head(); pos->next != nullptr; pos = pos->next) {
+			std::uintptr_t a = reinterpret_cast<std::uintptr_t>(pos),
+			               b = reinterpret_cast<std::uintptr_t>(pos->next);
+			sum += a < b ? b - a : a - b;
+		}
+		return sum / (length - 1);
 	}
 
 	void reverse() noexcept{
 		if(length <= 1) return;
 		node_t* l = nullptr, 
-		      * c = head, 
-		      * r = head->next;
+		      * c = head(), 
+		      * r = head()->next;
+		last = head();
+		prefetcher_t prefetcher{r};
 		while(c->next != nullptr) {
+			prefetcher.step();
 			c->next = l;
 			l = c;
 			c = r;
 			r = r->next;	
 		}
 		c->next = l;
-		head = c;
+		head() = c;
 
 	}
 
@@ -311,30 +534,39 @@ public:
 	void merge(linked_list&& other, const CompareT& comp = {}) {
 		//if a < b in some order, then comp(a, b) should returns true, otherwise returns false.
 		//merge two 'sorted' linked_list to one, by increasing order
-		if(this == &other) return;
-		node_t** ppnew = &head,
-		       * ps = head,
-		       * po = other.head;
+		//no allocator equality check, other's allocator should be equal to this one's, like std::list
+		if(this == &other or other.is_empty()) return;
+		node_t** ppnew = &head(),
+		       * ps = head(),
+		       * po = other.head();
+		prefetcher_t prefetcher_s{ps},
+		             prefetcher_o{po};
 		while(ps != nullptr && po != nullptr) {
 			// if(po->data < ps->data) {
 			if( comp(po->data, ps->data) ) {
 				//merge po
 				*ppnew = po;
 				po = po->next;
+				prefetcher_o.step();
 			}else {
 				*ppnew = ps;
 				ps = ps->next;
+				prefetcher_s.step();
 			}
 			ppnew = &((*ppnew)->next);
 		}
 		if(ps == nullptr) {
+			//the rest of other is the new tail
 			*ppnew = po;
+			last = other.last;
 		}else {
 			*ppnew = ps;
 		}
 		length += other.length;
 		other.length = 0;
-		other.head = nullptr;
+		other.head() = nullptr;
+		other.last = &other.before_head;
+		blocks.share(other.blocks);
 	}
 
 	template <typename CompareT = less<T>>
@@ -343,94 +575,274 @@ public:
 		quick_sort(comp);
 	}
 
-	//using merge sort to sort linked_list, inplace and stable, but slower than quick_sort()
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void sort(sort_policy::quick_t, const CompareT& comp = {}) {
+		quick_sort(comp);
+	}
+
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void sort(sort_policy::merge_t, const CompareT& comp = {}) {
+		merge_sort(comp);
+	}
+
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void sort(sort_policy::natural_t, const CompareT& comp = {}) {
+		natural_merge_sort(comp);
+	}
+
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void sort(sort_policy::gather_t, const CompareT& comp = {}) {
+		gather_sort(comp);
+	}
+
+	//using merge sort to sort linked_list, inplace and stable
 	template <typename CompareT = less<T>, bool overflow_check = false> 
 	requires predicate<CompareT, T, T>
 	void merge_sort(const CompareT& comp = {}) {
 		//if a < b in some order, then comp(a, b) should returns true, otherwise returns false.
 		if(length <= 1) return;
+		merge_sort_nodes<CompareT, overflow_check>(&head(), length, comp);
+		relink_last();
+	}
 
-		node_t** pos = &head;
 
-		//first sort
-		// if((*pos)->next->data < (*pos)->data) {
-		if( comp( (*pos)->next->data, (*pos)->data ) ) {
-			swap_nodes<false>(*pos, (*pos)->next);
-		}	
-		for(size_t i = 1; i < length / 2; i++) {
-			pos = &((*pos)->next->next);
-			// if((*pos)->next->data < (*pos)->data) {
-			if( comp( (*pos)->next->data, (*pos)->data ) ) {	
-				swap_nodes<false>(*pos, (*pos)->next);
+	//natural merge sort, inplace and stable, O(N) for sorted or reversed input:
+	//split the list into ascending runs and strictly descending runs (which are reversed in place), 
+	//then merge them with a timsort-like balanced run stack.
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void natural_merge_sort(const CompareT& comp = {}) {
+		if(length <= 1) return;
+
+		//the run lengths on the stack grow at least like fibonacci numbers, so 128 is enough
+		node_run stack[128];
+		size_t top = 0; //size of stack
+		node_t* pos = head();
+		while(pos != nullptr) {
+			stack[top++] = next_run(pos, comp);
+			//keep the invariants: 
+			//stack[i - 2].n > stack[i - 1].n + stack[i].n and stack[i - 1].n > stack[i].n
+			while(top > 1) {
+				size_t i = top - 1;
+				if( (i >= 2 and stack[i - 2].n <= stack[i - 1].n + stack[i].n) or 
+				    (i >= 3 and stack[i - 3].n <= stack[i - 2].n + stack[i - 1].n) ) {
+					merge_runs_at(stack, top, stack[i - 2].n < stack[i].n ? i - 2 : i - 1, comp);
+				}else if(stack[i - 1].n <= stack[i].n) {
+					merge_runs_at(stack, top, i - 1, comp);
+				}else break;
 			}
 		}
+		while(top > 1) merge_runs_at(stack, top, top - 2, comp);
 
-		//sort and merge
-		//O( log2(N) )
-		size_t merge_size = 2, group_size = 4;
-		while(group_size <= length) { 
-			//O( N )
-			pos = &head; //reset pos
-			//complete groups merging
-			for(size_t group = 0; group < (length / group_size); group++) {
-				node_t** mid = next_n<false>(pos, merge_size),
-				      ** to  = next_n<false>(mid, merge_size);
-				//merge the group, and point to next group
-				pos = merge_nodes(pos, mid, to, comp);
-				//it's an error: 
-				//pos = to; because where 'to' might be invalidated. 
+		head() = stack[0].first;
+		last = stack[0].last;
+	}
+
+
+	//LSD radix sort on an integral key, inplace and stable, O(N * sizeof(key)):
+	//distribute the nodes into 256 bucket chains per byte, and concatenate them without allocating.
+	//proj maps an element to its key, such as &polynormial_item::n, the bytes which are the same in all keys are skipped.
+	template <typename ProjectionT = std::identity>
+	requires radix_key<std::invoke_result_t<const ProjectionT&, const T&>>
+	void radix_sort(const ProjectionT& proj = {}) {
+		if(length <= 1) return;
+		using key_t = std::remove_cvref_t<std::invoke_result_t<const ProjectionT&, const T&>>;
+		using ukey_t = std::make_unsigned_t<key_t>;
+		auto key_of = [&proj](const node_t* node) {
+			ukey_t key = static_cast<ukey_t>(std::invoke(proj, node->data));
+			//flip the sign bit, so that negative keys are in front of the others
+			if constexpr(std::is_signed_v<key_t>) key ^= ukey_t(ukey_t{1} << (numeric_limits<ukey_t>::digits - 1));
+			return key;
+		};
+
+		//the bits which differ from the first key, collected during the first pass
+		ukey_t first_key = key_of(head()),
+		       diff = 0;
+
+		node_t*  buckets[256];
+		node_t** tails[256];
+		for(int shift = 0; shift < numeric_limits<ukey_t>::digits; shift += 8) {
+			if( shift != 0 and ((diff >> shift) & 0xff) == 0 ) continue;
+			for(size_t i = 0; i < 256; i++) tails[i] = &buckets[i];
+			//appending keeps the origin order of each bucket
+			for(node_t* pos = head(); pos != nullptr; pos = pos->next) {
+				ukey_t key = key_of(pos);
+				if(shift == 0) diff |= key ^ first_key;
+				size_t i = (key >> shift) & 0xff;
+				*tails[i] = pos;
+				tails[i] = &(pos->next);
 			}
-			//incomplete group merging
-			if((length % group_size) > merge_size) {
-				node_t** mid = next_n<false>(pos, merge_size);
-				merge_nodes(pos, mid, next_n<true>(mid, merge_size)/*this might out of range*/, comp);
+			node_t** pos = &head();
+			for(size_t i = 0; i < 256; i++) {
+				if(tails[i] == &buckets[i]) continue;
+				*pos = buckets[i];
+				pos = tails[i];
 			}
+			*pos = nullptr;
+			last = base_of(pos);
+		}
+	}
 
-			merge_size = group_size;
-			//overflow check, it's hard to reach this situation, so check is defaultly disabled.
-			if constexpr(overflow_check) {
-				if(group_size > (numeric_limits<size_t>::max() / 2)) {
-					group_size = numeric_limits<size_t>::max();
-					break;
-				}
-			}
-			group_size *= 2;
 
+	//introsort-like quick sort, inplace and stable, O(N * log2(N)) in the worst case:
+	//median of three pivot from the nodes at hand, two-way partition, 
+	//grouping the elements equal to the one in front of the range (many duplicates) at once,
+	//looping on the larger side, and falling back to merge sort when the recursion is too deep.
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void quick_sort(const CompareT& comp = {}) {
+		if(length <= 1) return;
+		quick_sort_nodes(&head(), tail(), length, nullptr, nullptr, 2 * static_cast<size_t>(std::bit_width(length)), comp);
+		relink_last();
+	}
+
+
+	//gather the node pointers into an array, sort the array, then relink the nodes in one pass.
+	//stable, the elements are never copied or moved, O(N) extra memory for the pointers.
+	//threads > 1 sorts the slices of the array on worker threads and merges them pairwise in parallel, 
+	//threads == 0 means std::thread::hardware_concurrency(), comp should not throw then.
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void gather_sort(const CompareT& comp = {}, size_t threads = 1) {
+		if(length <= 1) return;
+
+		std::vector<node_t*> nodes;
+		nodes.reserve(length);
+		for(node_t* pos = head(); pos != nullptr; pos = pos->next) nodes.push_back(pos);
+		auto node_comp = [&comp](const node_t* a, const node_t* b) {return comp(a->data, b->data); };
+
+		if(threads == 0) threads = std::thread::hardware_concurrency();
+		if(threads > length / 2) threads = length / 2;
+		if(threads <= 1) {
+			std::stable_sort(nodes.begin(), nodes.end(), node_comp);
+		}else {
+			//slice i is [bounds[i], bounds[i + 1])
+			std::vector<size_t> bounds(threads + 1);
+			for(size_t i = 0; i <= threads; i++) bounds[i] = length / threads * i + (i < length % threads ? i : length % threads);
+			auto slice = [&nodes, &bounds](size_t i) {return nodes.begin() + bounds[i]; };
+			{
+				std::vector<std::jthread> workers;
+				workers.reserve(threads);
+				for(size_t i = 0; i < threads; i++) {
+					workers.emplace_back([&slice, &node_comp, i] { std::stable_sort(slice(i), slice(i + 1), node_comp); });
+				}
+			} //join
+			for(size_t step = 1; step < threads; step *= 2) {
+				std::vector<std::jthread> workers;
+				for(size_t i = 0; i + step < threads; i += 2 * step) {
+					size_t to = i + 2 * step < threads ? i + 2 * step : threads;
+					workers.emplace_back([&slice, &node_comp, i, step, to] { std::inplace_merge(slice(i), slice(i + step), slice(to), node_comp); });
+				}
+			} //join
 		}
-		if(length > merge_size) {
-			//last merge
-			//where list contains a complete group and a incomplete group
-			node_t** mid = next_n<false>(&head, merge_size);
-			merge_nodes(&head, mid, next_n<true>(mid, merge_size)/*this also might out of range*/, comp);
+
+		node_t** pos = &head();
+		for(node_t* node: nodes) {
+			*pos = node;
+			pos = &(node->next);
 		}
+		*pos = nullptr;
+		last = base_of(pos);
 	}
 
 
+	//split the list into segments, merge_sort() them on worker threads, then merge them pairwise in parallel.
+	//inplace and stable, threads == 0 means std::thread::hardware_concurrency(), comp should not throw.
 	template <typename CompareT = less<T>>
 	requires predicate<CompareT, T, T>
-	void quick_sort(const CompareT& comp = {}) {
-		if(length <= 1) return;
-		quick_sort_recursive(head, tail()->next, comp);
+	void parallel_sort(const CompareT& comp = {}, size_t threads = 0) {
+		if(threads == 0) threads = std::thread::hardware_concurrency();
+		if(threads > length / 2) threads = length / 2;
+		if(threads <= 1) {
+			merge_sort(comp);
+			return;
+		}
+
+		//every segment holds at least 2 nodes, and shares the allocator with *this
+		std::vector<linked_list> segments;
+		segments.reserve(threads);
+		size_t segment_length = length / threads, 
+		       rest = length % threads;
+		for(size_t i = 0; i < threads; i++) {
+			linked_list& segment = segments.emplace_back(get_allocator());
+			size_t n = segment_length + (i < rest ? 1 : 0);
+			node_t** pos = next_n<false>(&head(), n);
+			segment.head() = head();
+			head() = *pos;
+			*pos = nullptr;
+			segment.last = base_of(pos);
+			segment.length = n;
+		}
+		last = &before_head;
+		length = 0;
+
+		{
+			std::vector<std::jthread> workers;
+			workers.reserve(threads);
+			for(auto& segment: segments) {
+				workers.emplace_back([&segment, &comp] { segment.merge_sort(comp); });
+			}
+		} //join
+
+		//merge tree, segments[i] is in front of segments[i + step], so merge() keeps it stable
+		for(size_t step = 1; step < threads; step *= 2) {
+			std::vector<std::jthread> workers;
+			for(size_t i = 0; i + step < threads; i += 2 * step) {
+				workers.emplace_back([&segments, &comp, i, step] { segments[i].merge(move(segments[i + step]), comp); });
+			}
+		} //join
+
+		steal(segments[0]);
 	}
 
 
 	template <typename CompareT = less_equal<T>> //where CompareT should be less_equal<T> to match sort(less<T>{})
 	requires predicate<CompareT, T, T>
 	bool is_sorted(const CompareT& comp = {}) {
-		node_t* pos = head;
+		node_t* pos = head();
+		prefetcher_t prefetcher{pos};
 		while(pos->next != nullptr) {
 			if( !comp(pos->data, pos->next->data) ) return false; 
 			pos = pos->next;
+			prefetcher.step();
 		}
 		return true;
 	}
+
+	//calls fn on the elements in order, the nodes of a batch are collected before fn is called on them,
+	//so that fn on the collected elements does not wait for the next node to be loaded.
+	//fn should not change the structure of the list
+	template <size_t BatchSize = 8, typename FnT>
+	requires std::invocable<FnT&, T&>
+	void for_each(FnT fn) {
+		for_each_batch<BatchSize>(head(), fn);
+	}
+
+	template <size_t BatchSize = 8, typename FnT>
+	requires std::invocable<FnT&, const T&>
+	void for_each(FnT fn) const{
+		for_each_batch<BatchSize>(static_cast<const node_t*>(head()), fn);
+	}
 	
 	friend void swap(linked_list& a, linked_list& b) noexcept{
-		node_t* temp = a.head;
+		//no allocator equality check when they are not propagated, like std::list
+		if constexpr(node_traits::propagate_on_container_swap::value) {
+			using std::swap;
+			swap(a.alloc, b.alloc);
+		}
+		swap(a.blocks, b.blocks);
+		node_t* temp = a.head();
+		node_base_t* temp_last = a.last;
 		size_t temp_len = a.length;
-		a.head = b.head;
+		a.head() = b.head();
+		a.last = b.is_empty() ? &a.before_head : b.last;
 		a.length = b.length;
-		b.head = temp;
+		b.head() = temp;
+		b.last = temp == nullptr ? &b.before_head : temp_last;
 		b.length = temp_len;
 	}
 
@@ -446,36 +858,29 @@ public:
 		//assume that a and b are sorted.
 
 		//merge two list, and return new list
-		linked_list temp;
-		node_t*  pa = a.head, 
-		      *  pb = b.head, 
-		      ** pt = &temp.head;
+		linked_list temp{allocator_traits<AllocatorT>::select_on_container_copy_construction(a.get_allocator())};
+		const node_t*  pa = a.head(), 
+		            *  pb = b.head();
+		node_t**       pt = &temp.head();
 
 		while(pa != nullptr and pb != nullptr) {
 			// (*pb)->data < (*pa)->data
 			if( comp(pb->data, pa->data) ) {
-				*pt = new node_t{pb->data};
+				*pt = temp.new_node(pb->data);
 				pb = pb->next;
 			}else {
-				*pt = new node_t{pa->data};
+				*pt = temp.new_node(pa->data);
 				pa = pa->next;
 			}
 			pt = &((*pt)->next);
 		}
-		if(pa != nullptr) {
-			do{
-				*pt = new node_t{pa->data};
-				pa = pa->next;
-				pt = &((*pt)->next);
-			}while(pa != nullptr);
-		}else {
-			do{
-				*pt = new node_t{pb->data};
-				pb = pb->next;
-				pt = &((*pt)->next);	
-			}while(pb != nullptr);
+		//the rest of one of them, both might be empty
+		for(const node_t* pos = pa != nullptr ? pa : pb; pos != nullptr; pos = pos->next) {
+			*pt = temp.new_node(pos->data);
+			pt = &((*pt)->next);
 		}
 		*pt = nullptr;
+		temp.last = base_of(pt);
 		temp.length = a.length + b.length;
 		return temp;
 
@@ -490,8 +895,10 @@ public:
 	friend OutputStreamT& operator<<(OutputStreamT& os, const linked_list& list)  {
 		os << '[';
 		if(list.size() != 0) {
+			prefetcher_t prefetcher{list.head()};
 			os << *list.cbegin();
 			for(auto it = ++list.cbegin(); it != list.cend(); ++it) {
+				prefetcher.step();
 				os << ", " << *it;
 			}
 		}
@@ -500,59 +907,420 @@ public:
 
 
 protected:
+
+	using prefetcher_t = node_prefetcher<node_t, PrefetchT::distance>;
+
+	node_t*& head() noexcept{return before_head.next; }
+	node_t* const & head() const noexcept{return before_head.next; }
 	
-	node_t*& tail() noexcept{
-		if(head == nullptr) return head;
-		node_t** pos = &head;
-		while((*pos)->next != nullptr) pos = &((*pos)->next);
-		return *pos;
+	node_t* tail() noexcept{
+		//O(1), nullptr if the list is empty
+		return is_empty() ? nullptr : static_cast<node_t*>(last);
 	}
 	
-	const node_t* const & tail() const noexcept{
-		if(head == nullptr) return head;
-		const node_t* const * pos = &head;
-		while((*pos)->next != nullptr) pos = &((*pos)->next);
-		return *pos;
+	const node_t* tail() const noexcept{
+		return is_empty() ? nullptr : static_cast<const node_t*>(last);
+	}
+
+	static node_base_t* base_of(node_t** pos) noexcept{
+		//pos always points to a 'next' member, which is the only member of node_base_t, 
+		//so they are pointer-interconvertible.
+		return reinterpret_cast<node_base_t*>(pos);
+	}
+
+	struct node_run {
+		//a detached chain, sorted in the sort algorithms, last->next == nullptr
+		node_t* first;
+		node_t* last;
+		size_t n;
+	};
+
+	template <typename... Args>
+	node_t* new_node(Args&&... args) {
+		//a spare node of the blocks is reused first
+		node_t* temp = blocks.take();
+		if(temp == nullptr) temp = node_traits::allocate(alloc, 1);
+		construct_node(temp, forward<Args>(args)...);
+		return temp;
+	}
+
+	template <typename... Args>
+	void construct_node(node_t* node, Args&&... args) {
+		try {
+			node_traits::construct(alloc, node, forward<Args>(args)...);
+		}catch(...) {
+			if(!blocks.put(node)) node_traits::deallocate(alloc, node, 1);
+			throw;
+		}
+	}
+
+	void delete_node(node_t* node) noexcept{
+		node_traits::destroy(alloc, node);
+		if(!blocks.put(node)) node_traits::deallocate(alloc, node, 1);
 	}
 
+	//constructs n > 0 nodes from it as a detached chain, and advances it, 
+	//the spare nodes are used first, then the rest are allocated in one block
+	template <typename IteratorT>
+	node_run new_nodes(IteratorT& it, size_t n) {
+		node_run run{nullptr, nullptr, 0};
+		node_t** pos = &run.first;
+		node_t* block = nullptr;
+		size_t used = 0, block_n = 0;
+		try {
+			for(; run.n < n; ++it, run.n++) {
+				node_t* node = block != nullptr ? block + used++ : blocks.take();
+				if(node == nullptr and n - run.n >= blocks.min_block_nodes) {
+					block_n = n - run.n;
+					block = blocks.allocate(alloc, block_n);
+					node = block + used++;
+				}
+				if(node == nullptr) {
+					*pos = new_node(*it, nullptr);
+				}else {
+					construct_node(node, *it, nullptr);
+					*pos = node;
+				}
+				run.last = *pos;
+				pos = &((*pos)->next);
+			}
+		}catch(...) {
+			*pos = nullptr;
+			for(node_t* node = run.first; node != nullptr; ) {
+				node_t* temp = node->next;
+				delete_node(node);
+				node = temp;
+			}
+			for(; used < block_n; used++) blocks.put(block + used);
+			throw;
+		}
+		return run;
+	}
+
+	template <typename BuildT>
+	void build(BuildT build_nodes) {
+		//for the constructors, the destructor is not called if they throw
+		try {
+			build_nodes();
+		}catch(...) {
+			clear();
+			throw;
+		}
+	}
+
+	template <typename IteratorT>
+	void append_n(IteratorT it, size_t n) {
+		if(n == 0) return;
+		node_run run = new_nodes(it, n);
+		last->next = run.first;
+		last = run.last;
+		length += n;
+	}
+
+	template <typename IteratorT, typename SentinelT>
+	void append(IteratorT first, SentinelT sentinel) {
+		if constexpr(std::forward_iterator<IteratorT>) {
+			append_n(first, static_cast<size_t>(std::ranges::distance(first, sentinel)));
+		}else {
+			for(; first != sentinel; ++first) push(*first);
+		}
+	}
+
+	template <typename IteratorT>
+	void assign_n(IteratorT it, size_t n) {
+		node_t** pos = &head();
+		size_t i = 0;
+		for(; i < n and *pos != nullptr; i++, ++it) {
+			(*pos)->data = *it;
+			pos = &((*pos)->next);
+		}
+		if(*pos != nullptr) erase_from(pos, n);
+		else append_n(move(it), n - i);
+	}
+
+	//erase *pos and the nodes after it, n is the new length
+	void erase_from(node_t** pos, size_t n) noexcept{
+		node_t* node = *pos;
+		*pos = nullptr;
+		last = base_of(pos);
+		length = n;
+		while(node != nullptr) {
+			node_t* temp = node->next;
+			delete_node(node);
+			node = temp;
+		}
+	}
+
+	template <size_t BatchSize, typename NodeT, typename FnT>
+	static void for_each_batch(NodeT* pos, FnT& fn) {
+		static_assert(BatchSize != 0);
+		NodeT* batch[BatchSize];
+		prefetcher_t prefetcher{pos};
+		while(pos != nullptr) {
+			size_t n = 0;
+			for(; n < BatchSize and pos != nullptr; n++) {
+				batch[n] = pos;
+				pos = pos->next;
+				prefetcher.step();
+			}
+			for(size_t i = 0; i < n; i++) fn(batch[i]->data);
+		}
+	}
+
+	void steal(linked_list& other) noexcept{
+		//assume that *this is empty
+		head() = other.head();
+		last = other.is_empty() ? &before_head : other.last;
+		length = other.length;
+		other.head() = nullptr;
+		other.last = &other.before_head;
+		other.length = 0;
+	}
+
+	void relink_last() noexcept{
+		//O(n), for the algorithms which lose track of the last node
+		node_t** pos = &head();
+		while(*pos != nullptr) pos = &((*pos)->next);
+		last = base_of(pos);
+	}
 
-	//erase_after is really rubbish
+	//unlink *pos without deallocating it, where pos might be &head() or &(some_node->next)
+	node_t* detach(node_t** pos) noexcept{
+		node_t* node = *pos;
+		if(node == nullptr) return nullptr;
+		if(node == last) last = base_of(pos);
+		*pos = node->next;
+		length--;
+		return node;
+	}
+
+	void link_after(node_base_t* pos, node_handle_t& handle) noexcept{
+		if(handle.is_empty()) return;
+		node_t* node = handle.take(blocks);
+		node->next = pos->next;
+		pos->next = node;
+		if(pos == last) last = node;
+		length++;
+	}
+
+	//erase *pos, where pos might be &head() or &(some_node->next)
 	void erase(node_t** pos) {
 		if(pos == nullptr or *pos == nullptr) return;
+		if(*pos == last) last = base_of(pos);
 		node_t* next_of_pos = (*pos)->next;
-		delete *pos;
+		delete_node(*pos);
 		*pos = next_of_pos; 
 		length--;
 	}
 
 	template <typename CompareT>
 	requires predicate<CompareT, T, T>
-	static void quick_sort_recursive(node_t*& from, node_t* to, const CompareT& comp) {
-		//assume that from != nullptr and from->...->next == to
-
-		//only one element
-		if(from == to or from->next == nullptr) return; 
-		//only two elements
-		if(from->next == to) {
-			if(comp(to->data, from->data)) swap_nodes<false>(from, from->next);
-			return;
+	static node_run next_run(node_t*& pos, const CompareT& comp) {
+		//detach the run start from pos, and point pos to the node after it
+		node_t* first = pos;
+		size_t n = 1;
+		pos = pos->next;
+		if(pos != nullptr and comp(pos->data, first->data)) {
+			//strictly descending run, reverse it while collecting
+			node_t* reversed = first;
+			first->next = nullptr;
+			while(pos != nullptr and comp(pos->data, reversed->data)) {
+				node_t* temp = pos->next;
+				pos->next = reversed;
+				reversed = pos;
+				pos = temp;
+				n++;
+			}
+			return {reversed, first, n};
+		}
+		node_t* last_node = first;
+		while(pos != nullptr and !comp(pos->data, last_node->data)) {
+			last_node = pos;
+			pos = pos->next;
+			n++;
+		}
+		last_node->next = nullptr;
+		return {first, last_node, n};
+	}
+
+	template <typename CompareT>
+	requires predicate<CompareT, T, T>
+	static node_run merge_runs(const node_run& a, const node_run& b, const CompareT& comp) {
+		//a is in front of b, so that takes a first when they are equal
+		node_t*  first = nullptr,
+		      ** pos = &first,
+		      *  pa = a.first,
+		      *  pb = b.first;
+		while(pa != nullptr and pb != nullptr) {
+			if( comp(pb->data, pa->data) ) {
+				*pos = pb;
+				pb = pb->next;
+			}else {
+				*pos = pa;
+				pa = pa->next;
+			}
+			pos = &((*pos)->next);
+		}
+		*pos = pa != nullptr ? pa : pb;
+		return {first, pa != nullptr ? a.last : b.last, a.n + b.n};
+	}
+
+	template <typename CompareT>
+	requires predicate<CompareT, T, T>
+	static void merge_runs_at(node_run* stack, size_t& top, size_t i, const CompareT& comp) {
+		//merge stack[i] and stack[i + 1] to stack[i]
+		stack[i] = merge_runs(stack[i], stack[i + 1], comp);
+		if(i + 2 < top) stack[i + 1] = stack[i + 2];
+		top--;
+	}
+
+	template <typename CompareT, bool overflow_check = false>
+	requires predicate<CompareT, T, T>
+	static void merge_sort_nodes(node_t** from, size_t n, const CompareT& comp) {
+		//sort the n nodes start from *from, the node after them is unchanged.
+		if(n <= 1) return;
+
+		node_t** pos = from;
+
+		//first sort
+		for(size_t i = 0; i < n / 2; i++) {
+			// if((*pos)->next->data < (*pos)->data) {
+			if( comp( (*pos)->next->data, (*pos)->data ) ) {	
+				swap_nodes<false>(*pos, (*pos)->next);
+			}
+			pos = &((*pos)->next->next);
 		}
 
-		node_t*  pivot = from, 
-		      ** pos = &(from->next);
+		//sort and merge
+		//O( log2(N) )
+		for(size_t merge_size = 2; merge_size < n; merge_size *= 2) {
+			//O( N )
+			pos = from; //reset pos
+			for(size_t merged = 0; merged + merge_size < n; merged += 2 * merge_size) {
+				//the last group might be incomplete
+				size_t rest = n - merged - merge_size;
+				node_t** mid = next_n<false>(pos, merge_size),
+				      ** to  = next_n<false>(mid, rest < merge_size ? rest : merge_size);
+				//merge the group, and point to next group
+				pos = merge_nodes(pos, mid, to, comp);
+				//it's an error: 
+				//pos = to; because where 'to' might be invalidated. 
+			}
+			//overflow check, it's hard to reach this situation, so check is defaultly disabled.
+			if constexpr(overflow_check) {
+				if(merge_size > (numeric_limits<size_t>::max() / 2)) break;
+			}
+		}
+	}
 
-		while(*pos != to) {
-			if(comp((*pos)->data, pivot->data)) {
-				node_t* temp = (*pos)->next;
-				(*pos)->next = from;
-				from = *pos;
-				*pos = temp;
+	template <typename CompareT>
+	requires predicate<CompareT, T, T>
+	static void quick_sort_nodes(node_t** from, node_t* last, size_t n, node_t* sample, const T* lower, size_t depth_limit, const CompareT& comp) {
+		//sort the n nodes start from *from, where last is the n-th node, the node after them is unchanged.
+		//sample is one of them near the middle or nullptr, 
+		//lower is the element right in front of them after sorting, nullptr if there is none
+		while(n > 1) {
+			if(depth_limit == 0) {
+				merge_sort_nodes(from, n, comp);
+				return;
+			}
+			depth_limit--;
+
+			//median of three nodes at hand, walking to the middle would cost a half pass,
+			//the pivot node is only relinked, so the reference keeps valid
+			node_t*  pivot_node = median_of_three(*from, sample != nullptr ? sample : (*from)->next, last, comp);
+			const T& pivot = pivot_node->data;
+			node_t*  to = last->next,
+			      *  left = nullptr,
+			      *  right = nullptr,
+			      *  left_sample = nullptr,
+			      *  right_sample = nullptr,
+			      ** pl = &left,
+			      ** pr = &right;
+			//the nodes appended at a quarter are near the middle of the parts if they are balanced
+			size_t left_n = 0, right_n = 0, quarter = n / 4;
+			auto append_left = [&](node_t* pos) {
+				*pl = pos;
+				pl = &(pos->next);
+				if(++left_n == quarter) left_sample = pos;
+			};
+			auto append_right = [&](node_t* pos) {
+				*pr = pos;
+				pr = &(pos->next);
+				if(++right_n == quarter) right_sample = pos;
+			};
+
+			node_t* pos = *from;
+			prefetcher_t prefetcher{pos};
+			if(lower != nullptr and !comp(*lower, pivot)) {
+				//the pivot equals the element in front, so do the ones not greater than it, which are in place after partition
+				for(size_t i = 0; i < n; i++) {
+					prefetcher.step();
+					if( comp(pivot, pos->data) ) append_right(pos);
+					else append_left(pos);
+					pos = pos->next;
+				}
+				*pr = to;
+				*pl = right;
+				*from = left;
+				from = pl;
+				last = right_n == 0 ? nullptr : static_cast<node_t*>(base_of(pr));
+				n = right_n;
+				sample = right_sample;
+				continue;
+			}
+
+			//two-way partition without the pivot node, appending keeps the origin order of each part,
+			//the nodes equal to the pivot stay on the side where they were
+			size_t i = 0;
+			for(; pos != pivot_node; i++) {
+				prefetcher.step();
+				if( comp(pivot, pos->data) ) append_right(pos);
+				else append_left(pos);
+				pos = pos->next;
+			}
+			prefetcher.step();
+			pos = pos->next;
+			for(i++; i < n; i++) {
+				prefetcher.step();
+				if( comp(pos->data, pivot) ) append_left(pos);
+				else append_right(pos);
+				pos = pos->next;
+			}
+			//link from the back, where pl might be &left and pr might be &right
+			*pr = to;
+			pivot_node->next = right;
+			*pl = pivot_node;
+			*from = left;
+
+			node_t* left_last = left_n == 0 ? nullptr : static_cast<node_t*>(base_of(pl)),
+			      * right_last = right_n == 0 ? nullptr : static_cast<node_t*>(base_of(pr));
+			//recurse on the smaller side, loop on the larger side
+			if(left_n < right_n) {
+				quick_sort_nodes(from, left_last, left_n, left_sample, lower, depth_limit, comp);
+				from = &(pivot_node->next);
+				last = right_last;
+				n = right_n;
+				sample = right_sample;
+				lower = &pivot;
 			}else {
-				pos = &((*pos)->next);
+				quick_sort_nodes(&(pivot_node->next), right_last, right_n, right_sample, &pivot, depth_limit, comp);
+				last = left_last;
+				n = left_n;
+				sample = left_sample;
 			}
 		}
-		quick_sort_recursive(from, pivot, comp);
-		quick_sort_recursive(pivot->next, to, comp);	
+	}
+
+	template <typename CompareT>
+	requires predicate<CompareT, T, T>
+	static node_t* median_of_three(node_t* a, node_t* b, node_t* c, const CompareT& comp) {
+		if( comp(b->data, a->data) ) std::swap(a, b);
+		if( comp(c->data, b->data) ) {
+			b = c;
+			if( comp(b->data, a->data) ) b = a;
+		}
+		return b;
 	}
 
 	template <bool null_check = true>
@@ -633,7 +1401,7 @@ protected:
 
 
 
-}; //class linked_list<T>
+}; //class linked_list<T, AllocatorT>
 
 
 
@@ -0,0 +1,269 @@
+#pragma once
+
+//基于双向链表与开放寻址哈希表的LRU/LFU缓存实现
+
+#include <bit>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <concepts>
+#include <functional>
+
+#include <double_list.hpp>
+
+namespace rais::study {
+
+using std::size_t;
+using std::uint64_t;
+using std::move;
+using std::forward;
+using std::allocator;
+using std::allocator_traits;
+
+//concepts
+using std::same_as;
+using std::convertible_to;
+
+//policy tags of lru_cache
+namespace cache_policy {
+	struct lru_t {}; //evicts the least recently used entry
+	struct lfu_t {}; //evicts the least frequently used entry, and the least recently used one among them
+
+	inline constexpr lru_t lru{};
+	inline constexpr lfu_t lfu{};
+} //namespace cache_policy
+
+struct cache_stats {
+	size_t hits = 0;
+	size_t misses = 0;
+	size_t evictions = 0;
+};
+
+
+/*
+ * LRU/LFU缓存实现.
+ * - 条目存放在double_list的节点中, 开放寻址(线性探测)哈希表保存键到节点的映射, 删除时后移元素而不使用墓碑
+ * - 哈希值经过斐波那契乘法散列后取高位作为起始槽, 因此std::hash对整数的恒等映射下, 等步长的键也不会聚集
+ * - 条目按访问频率分到若干桶中, 桶按频率升序链接, 每个桶内的条目按最近访问顺序排列(头部为最近访问);
+ *   LRU策略只有一个桶
+ * - get, put, erase与淘汰均为O(1), 通过splice在链表之间移动节点, 满容量时put复用被淘汰的节点,
+ *   清空的桶也会被保留复用
+ */
+template <typename K, typename V, typename PolicyT = cache_policy::lru_t, typename HashT = std::hash<K>, typename KeyEqualT = std::equal_to<K>, typename AllocatorT = allocator<std::pair<const K, V>>>
+requires same_as<PolicyT, cache_policy::lru_t> or same_as<PolicyT, cache_policy::lfu_t>
+class lru_cache {
+
+public:
+
+	using key_t = K;
+	using value_t = V;
+	using policy_t = PolicyT;
+	using allocator_t = AllocatorT;
+
+	static constexpr bool is_lfu = same_as<PolicyT, cache_policy::lfu_t>;
+
+protected:
+
+	struct bucket;
+	struct entry {
+		K key;
+		V value;
+		double_node<bucket>* owner; //the bucket node which holds the entry
+	};
+
+	using entry_list = double_list<entry, typename allocator_traits<AllocatorT>::template rebind_alloc<entry>>;
+	struct bucket {
+		size_t freq;
+		entry_list entries;
+	};
+	using bucket_list = double_list<bucket, typename allocator_traits<AllocatorT>::template rebind_alloc<bucket>>;
+	using entry_node = typename entry_list::node_t;
+	using bucket_node = typename bucket_list::node_t;
+
+	struct slot {
+		entry_node* node = nullptr; //nullptr if the slot is empty
+		size_t hash = 0;
+	};
+
+	bucket_list buckets;         //ascending freq, the back entry of the front bucket is the eviction candidate
+	bucket_list spare_buckets;   //the emptied buckets for reuse
+	entry_list spare_entries;    //holds an evicted node before it's reused
+	std::vector<slot, typename allocator_traits<AllocatorT>::template rebind_alloc<slot>> table;
+	size_t mask;
+	int shift; //64 - log2(table.size())
+	size_t cap;
+	size_t len = 0;
+	cache_stats counters;
+	[[no_unique_address]] HashT hasher;
+	[[no_unique_address]] KeyEqualT key_eq;
+
+public:
+
+	explicit lru_cache(size_t capacity, const HashT& hasher = {}, const KeyEqualT& key_eq = {}, const AllocatorT& alloc = {}):
+		buckets(alloc), spare_buckets(alloc), spare_entries(alloc),
+		//the load factor is at most 0.5, so that the probing always stops at an empty slot
+		table(std::bit_ceil(capacity * 2 < 2 ? size_t{2} : capacity * 2), alloc),
+		mask(table.size() - 1), shift(64 - std::countr_zero(table.size())), cap(capacity), hasher(hasher), key_eq(key_eq)
+	{
+		if constexpr(!is_lfu) buckets.push(bucket{1, entry_list(alloc)});
+	}
+	lru_cache(const lru_cache&) = delete;
+	lru_cache& operator=(const lru_cache&) = delete;
+
+	size_t size() const noexcept{return len; }
+	size_t capacity() const noexcept{return cap; }
+	bool is_empty() const noexcept{return len == 0; }
+
+	const cache_stats& stats() const noexcept{return counters; }
+	void reset_stats() noexcept{counters = {}; }
+
+	//returns nullptr if key is missing, otherwise marks the entry as used
+	V* get(const K& key) {
+		slot& s = table[find_slot(key, hasher(key))];
+		if(s.node == nullptr) {
+			counters.misses++;
+			return nullptr;
+		}
+		counters.hits++;
+		touch(s.node);
+		return &(s.node->data.value);
+	}
+
+	//no promotion and no stats
+	const V* peek(const K& key) const{
+		const slot& s = table[find_slot(key, hasher(key))];
+		return s.node == nullptr ? nullptr : &(s.node->data.value);
+	}
+
+	bool contains(const K& key) const{return peek(key) != nullptr; }
+
+	//insert or assign, evicts an entry if the cache is full, returns nullptr if the capacity is 0
+	template <typename U>
+	requires convertible_to<U, const V&>
+	V* put(const K& key, U&& value) {
+		if(cap == 0) return nullptr;
+		size_t h = hasher(key);
+		if(entry_node* node = table[find_slot(key, h)].node; node != nullptr) {
+			node->data.value = forward<U>(value);
+			touch(node);
+			return &(node->data.value);
+		}
+
+		if(len == cap) {
+			//evict, the node is reused below
+			entry_node* victim = buckets.head->data.entries.head->priv;
+			erase_slot(find_slot(victim->data.key, hasher(victim->data.key)));
+			detach(victim, spare_entries);
+			len--;
+			counters.evictions++;
+		}
+		entry_node* node;
+		if(spare_entries.is_empty()) {
+			spare_entries.push(entry{key, V(forward<U>(value)), nullptr});
+			node = spare_entries.head;
+		}else {
+			node = spare_entries.head;
+			node->data.key = key;
+			node->data.value = forward<U>(value);
+		}
+
+		bucket_node* b = buckets.head;
+		if constexpr(is_lfu) {
+			if(b == nullptr or b->data.freq != 1) b = new_bucket(buckets.begin(), 1);
+		}
+		b->data.entries.splice(b->data.entries.begin(), spare_entries, spare_entries.begin());
+		node->data.owner = b;
+		table[find_slot(key, h)] = slot{node, h};
+		len++;
+		return &(node->data.value);
+	}
+
+	bool erase(const K& key) {
+		size_t i = find_slot(key, hasher(key));
+		entry_node* node = table[i].node;
+		if(node == nullptr) return false;
+		erase_slot(i);
+		detach(node, spare_entries);
+		spare_entries.clear();
+		len--;
+		return true;
+	}
+
+	void clear() {
+		//the stats are kept
+		for(bucket_node* b = buckets.head; b != nullptr; b = b->next) b->data.entries.clear();
+		if constexpr(is_lfu) {
+			spare_buckets.splice(spare_buckets.end(), buckets);
+		}
+		for(auto& s: table) s = slot{};
+		len = 0;
+	}
+
+protected:
+
+	size_t home_slot(size_t h) const noexcept{
+		//fibonacci hashing, the high bits of the product depend on all the bits of h
+		return static_cast<size_t>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> shift);
+	}
+
+	size_t find_slot(const K& key, size_t h) const{
+		//the slot of key, or the empty slot where key should be
+		size_t i = home_slot(h);
+		while(table[i].node != nullptr and !(table[i].hash == h and key_eq(table[i].node->data.key, key))) i = (i + 1) & mask;
+		return i;
+	}
+
+	void erase_slot(size_t i) noexcept{
+		//backward shift the following slots of the probing sequence
+		for(size_t j = (i + 1) & mask; table[j].node != nullptr; j = (j + 1) & mask) {
+			size_t ideal = home_slot(table[j].hash);
+			//move table[j] to i unless its ideal slot is cyclically in (i, j]
+			bool stays = i <= j ? (i < ideal and ideal <= j) : (i < ideal or ideal <= j);
+			if(!stays) {
+				table[i] = table[j];
+				i = j;
+			}
+		}
+		table[i] = slot{};
+	}
+
+	void touch(entry_node* node) {
+		//O(1), move node to the front of its next frequency's bucket (LFU) or of its bucket (LRU)
+		bucket_node* b = node->data.owner;
+		if constexpr(!is_lfu) {
+			b->data.entries.splice(b->data.entries.begin(), b->data.entries, typename entry_list::iterator_t{node});
+		}else {
+			bucket_node* nb = b->next;
+			if(nb == nullptr or nb->data.freq != b->data.freq + 1) nb = new_bucket(typename bucket_list::iterator_t{nb}, b->data.freq + 1);
+			nb->data.entries.splice(nb->data.entries.begin(), b->data.entries, typename entry_list::iterator_t{node});
+			node->data.owner = nb;
+			if(b->data.entries.is_empty()) spare_buckets.splice(spare_buckets.begin(), buckets, typename bucket_list::iterator_t{b});
+		}
+	}
+
+	void detach(entry_node* node, entry_list& to) noexcept{
+		//move node from its bucket to the front of to, an emptied bucket is kept for reuse (LFU)
+		bucket_node* b = node->data.owner;
+		to.splice(to.begin(), b->data.entries, typename entry_list::iterator_t{node});
+		if constexpr(is_lfu) {
+			if(b->data.entries.is_empty()) spare_buckets.splice(spare_buckets.begin(), buckets, typename bucket_list::iterator_t{b});
+		}
+	}
+
+	bucket_node* new_bucket(typename bucket_list::iterator_t pos, size_t freq) {
+		//link a bucket in front of pos, reuses a spare bucket if possible
+		if(spare_buckets.is_empty()) {
+			buckets.insert(pos, bucket{freq, entry_list(spare_entries.get_allocator())});
+		}else {
+			spare_buckets.head->data.freq = freq;
+			buckets.splice(pos, spare_buckets, spare_buckets.begin());
+		}
+		return pos.get_ptr() != nullptr ? pos.get_ptr()->priv : buckets.head->priv;
+	}
+
+}; //class lru_cache<K, V, PolicyT, HashT, KeyEqualT, AllocatorT>
+
+
+} //namespace rais::study
@@ -0,0 +1,173 @@
+#pragma once
+
+//node blocks of the batch operations of node based containers, such as linked_list and double_list
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <functional>
+
+namespace rais::study {
+
+using std::size_t;
+using std::allocator_traits;
+
+
+/*
+ * 批量分配的节点块.
+ * - 一批节点通过一次node_traits::allocate(alloc, n)分配为一个连续的块, 块中的节点不能单独释放,
+ *   销毁后挂入所属链表的空闲链表(spare), 下次分配节点时优先复用
+ * - 块属于一个组(group), 组由引用计数管理, 链表之间移动节点(splice, merge等)时两个链表的组合并,
+ *   因此节点所在的块总是在持有它的链表的组中, 组的最后一个引用被释放时才释放所有的块
+ * - 没有批量分配过节点的链表不持有组, 其操作只多出一次空指针判断
+ * - 判断节点是否属于块需要遍历组中的块, 因此小批量的节点仍逐个分配
+ * - 由容器持有, 节点的分配与释放使用容器的分配器, 容器析构前应调用release(); 非线程安全
+ * - 块与组的簿记结构由std::allocator分配, 不占用节点分配器(如slab_allocator的内存池)中为节点准备的槽
+ */
+template <typename NodeT, typename NodeAllocatorT>
+class node_blocks {
+
+	using node_traits = allocator_traits<NodeAllocatorT>;
+
+	struct block {
+		NodeT* nodes;
+		size_t n;
+		block* next;
+	};
+	struct group {
+		group* parent; //the group which it's merged into, nullptr if it's a root
+		block* blocks; //only the root holds the blocks
+		size_t refs;   //the containers and the merged groups which refer to it
+	};
+	struct spare_node {
+		spare_node* next;
+	};
+
+	//the bookkeeping is not allocated by the node allocator, which might be tuned for the nodes
+	using block_allocator_t = std::allocator<block>;
+	using group_allocator_t = std::allocator<group>;
+
+	group* owner = nullptr;
+	spare_node* spare = nullptr;
+
+public:
+
+	//the batches smaller than it are allocated node by node
+	static constexpr size_t min_block_nodes = 8;
+
+	node_blocks() noexcept{}
+	node_blocks(const node_blocks&) = delete;
+	node_blocks& operator=(const node_blocks&) = delete;
+
+	bool is_empty() const noexcept{return owner == nullptr; }
+
+	//a spare node, which is not constructed, nullptr if there is none
+	NodeT* take() noexcept{
+		if(spare == nullptr) return nullptr;
+		void* temp = spare;
+		spare = spare->next;
+		return static_cast<NodeT*>(temp);
+	}
+
+	//keeps a destroyed node as a spare node if it's in a block, otherwise returns false
+	bool put(NodeT* node) noexcept{
+		if(owner == nullptr or !contains(node)) return false;
+		spare = ::new(static_cast<void*>(node)) spare_node{spare};
+		return true;
+	}
+
+	//a block of n nodes, which are not constructed
+	NodeT* allocate(NodeAllocatorT& alloc, size_t n) {
+		if(owner == nullptr) {
+			group* temp = group_allocator_t{}.allocate(1);
+			owner = ::new(static_cast<void*>(temp)) group{nullptr, nullptr, 1};
+		}
+		block* temp = block_allocator_t{}.allocate(1);
+		NodeT* nodes;
+		try {
+			nodes = node_traits::allocate(alloc, n);
+		}catch(...) {
+			block_allocator_t{}.deallocate(temp, 1);
+			throw;
+		}
+		group* r = root();
+		r->blocks = ::new(static_cast<void*>(temp)) block{nodes, n, r->blocks};
+		return nodes;
+	}
+
+	//O(1) if one of them has no group, the nodes of other are moving to *this
+	void share(node_blocks& other) noexcept{
+		if(other.owner == nullptr) return;
+		group* b = other.root();
+		if(owner == nullptr) {
+			owner = b;
+			b->refs++;
+			return;
+		}
+		group* a = root();
+		if(a == b) return;
+		//merge b into a
+		block** pos = &(a->blocks);
+		while(*pos != nullptr) pos = &((*pos)->next);
+		*pos = b->blocks;
+		b->blocks = nullptr;
+		b->parent = a;
+		a->refs++;
+	}
+
+	//*this should be empty
+	void adopt(node_blocks& other) noexcept{
+		owner = other.owner;
+		spare = other.spare;
+		other.owner = nullptr;
+		other.spare = nullptr;
+	}
+
+	//the spare nodes are dropped, the blocks are deallocated when the group is not referred any more,
+	//returns the bytes of the deallocated nodes
+	size_t release(NodeAllocatorT& alloc) noexcept{
+		size_t bytes = 0;
+		spare = nullptr;
+		group* pos = owner;
+		owner = nullptr;
+		while(pos != nullptr and --(pos->refs) == 0) {
+			for(block* b = pos->blocks; b != nullptr; ) {
+				block* temp = b->next;
+				bytes += b->n * sizeof(NodeT);
+				node_traits::deallocate(alloc, b->nodes, b->n);
+				block_allocator_t{}.deallocate(b, 1);
+				b = temp;
+			}
+			group* parent = pos->parent;
+			group_allocator_t{}.deallocate(pos, 1);
+			pos = parent;
+		}
+		return bytes;
+	}
+
+	friend void swap(node_blocks& a, node_blocks& b) noexcept{
+		std::swap(a.owner, b.owner);
+		std::swap(a.spare, b.spare);
+	}
+
+protected:
+
+	group* root() const noexcept{
+		group* pos = owner;
+		while(pos->parent != nullptr) pos = pos->parent;
+		return pos;
+	}
+
+	bool contains(const NodeT* node) const noexcept{
+		//std::less gives a total order of the pointers to different blocks
+		std::less<const NodeT*> before;
+		for(const block* b = root()->blocks; b != nullptr; b = b->next) {
+			if(!before(node, b->nodes) and before(node, b->nodes + b->n)) return true;
+		}
+		return false;
+	}
+
+}; //class node_blocks<NodeT, NodeAllocatorT>
+
+} //namespace rais::study
@@ -0,0 +1,116 @@
+#pragma once
+
+//node handles of linked_list and double_list, which own an extracted node
+
+#include <memory>
+#include <utility>
+
+#include <prefetch.hpp>
+#include <node_blocks.hpp>
+
+namespace rais::study {
+
+using std::move;
+using std::allocator_traits;
+
+template <typename T, typename AllocatorT, typename PrefetchT>
+requires prefetch_policy_type<PrefetchT>
+class linked_list;
+
+template <typename T, typename AllocatorT, typename PrefetchT>
+requires prefetch_policy_type<PrefetchT>
+class double_list;
+
+
+/*
+ * 节点句柄.
+ * - 持有从链表中extract出的节点, 节点可以不经释放与分配地重新链接到同一个或另一个链表中
+ * - 节点可能位于一个块(node_blocks)中, 因此句柄同时持有所在块的组, 来源链表析构后节点仍然有效
+ * - 句柄析构时销毁并释放它持有的节点; 插入到的链表的分配器应与句柄的分配器相等, 不作检查
+ * - 只能移动, 不能拷贝
+ */
+template <typename NodeT, typename NodeAllocatorT>
+class node_handle {
+
+	template <typename T, typename AllocatorT, typename PrefetchT>
+	requires prefetch_policy_type<PrefetchT>
+	friend class linked_list;
+
+	template <typename T, typename AllocatorT, typename PrefetchT>
+	requires prefetch_policy_type<PrefetchT>
+	friend class double_list;
+
+	using node_traits = allocator_traits<NodeAllocatorT>;
+
+	NodeT* node = nullptr;
+	[[no_unique_address]] NodeAllocatorT alloc;
+	node_blocks<NodeT, NodeAllocatorT> blocks;
+
+	node_handle(NodeT* node, const NodeAllocatorT& alloc, node_blocks<NodeT, NodeAllocatorT>& from) noexcept: node{node}, alloc(alloc) {
+		blocks.share(from);
+	}
+
+public:
+
+	using element_t = decltype(std::declval<NodeT&>().data);
+	using allocator_t = NodeAllocatorT;
+
+	node_handle() noexcept{}
+	node_handle(const node_handle&) = delete;
+	node_handle& operator=(const node_handle&) = delete;
+	node_handle(node_handle&& other) noexcept: node{other.node}, alloc(other.alloc) {
+		other.node = nullptr;
+		blocks.adopt(other.blocks);
+	}
+	node_handle& operator=(node_handle&& other) noexcept{
+		if(this == &other) return *this;
+		reset();
+		node = other.node;
+		alloc = other.alloc;
+		other.node = nullptr;
+		blocks.adopt(other.blocks);
+		return *this;
+	}
+	~node_handle() {
+		reset();
+	}
+
+	bool is_empty() const noexcept{return node == nullptr; }
+	explicit operator bool() const noexcept{return node != nullptr; }
+
+	//no empty check
+	element_t& value() const noexcept{return node->data; }
+
+	allocator_t get_allocator() const noexcept{return alloc; }
+
+	//destroys the node, the handle becomes empty
+	void reset() noexcept{
+		if(node != nullptr) {
+			node_traits::destroy(alloc, node);
+			if(!blocks.put(node)) node_traits::deallocate(alloc, node, 1);
+			node = nullptr;
+		}
+		blocks.release(alloc);
+	}
+
+	friend void swap(node_handle& a, node_handle& b) noexcept{
+		using std::swap;
+		swap(a.node, b.node);
+		swap(a.alloc, b.alloc);
+		swap(a.blocks, b.blocks);
+	}
+
+protected:
+
+	//the container takes the node and the blocks it's in
+	NodeT* take(node_blocks<NodeT, NodeAllocatorT>& to) noexcept{
+		NodeT* temp = node;
+		node = nullptr;
+		to.share(blocks);
+		blocks.release(alloc);
+		return temp;
+	}
+
+}; //class node_handle<NodeT, NodeAllocatorT>
+
+} //namespace rais::study
@@ -1,9 +1,24 @@
 #pragma once
 
+#include <bit>
+#include <cmath>
+#include <span>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <complex>
+#include <numbers>
+#include <ostream>
+#include <stdexcept>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
 #include <linked_list.hpp>
 
 namespace rais::study {
 
+using std::remove_cvref_t;
 
 
 struct polynormial_item {
@@ -17,17 +32,80 @@ class polynormial_function;
 using polyfunc = polynormial_function;
 using polyitem = polynormial_item;
 
+//policy tags of polynormial_function::multiply()
+namespace multiply_policy {
+	struct automatic_t {};
+	struct sparse_t {};
+	struct schoolbook_t {};
+	struct karatsuba_t {};
+	struct fft_t {};
+
+	inline constexpr automatic_t  automatic{};
+	inline constexpr sparse_t     sparse{};
+	inline constexpr schoolbook_t schoolbook{};
+	inline constexpr karatsuba_t  karatsuba{};
+	inline constexpr fft_t        fft{};
+} //namespace multiply_policy
+
+/*
+ * 多项式实现.
+ * - 稀疏存储: 按n递增排序且系数非零的项的链表, 即基类linked_list<polynormial_item>
+ * - 稠密存储: 以n为下标的系数数组coefs, coefs.back() != 0, 此时链表为空
+ * - 构造与regularize()时按内存占用选择存储方式: 非零项的节点不小于系数数组时使用稠密存储,
+ *   即size() * sizeof(node_t) >= (degree() + 1) * sizeof(double), 对于24字节的节点约为密度 >= 1/3
+ * - 稠密存储之间的加法为逐个系数相加, 可以被向量化
+ * - 迭代器按n递增访问非零项, 解引用得到项的值, 两种存储方式的迭代方式相同
+ * - 乘法按存储方式与规模选择算法(multiply_policy::automatic):
+ *   有稀疏操作数时为Johnson的堆乘法, 按n递增地产生结果的项, O(k * m * log(min(k, m))), 不需要再排序;
+ *   都是稠密存储时, 较短的操作数小于karatsuba_threshold时为逐项乘法, 小于fft_threshold时为Karatsuba乘法,
+ *   否则为FFT卷积, 并按误差上界舍入: 系数都是整数且上界小于0.5时舍入为整数(结果精确), 否则绝对值不超过上界的系数置零
+ * - eval(x)求值: 稠密存储为Horner方法; 稀疏存储按n递增累加, 相邻项之间的x的幂用平方求幂
+ * - eval_many()先取出按n递减的Horner形式(稀疏存储的指数差用平方求幂), 再以eval_batch个点为一批求值,
+ *   每一批的各点互相独立, 可以被编译器向量化为simd_doubles宽的指令, 不足一批的点补齐后用同样的方式求值
+ * - add_term()逐项添加: 稠密存储直接修改系数; 稀疏存储在采样节点的索引(每sqrt(size()) / index_stride_divisor个节点采样一个)上二分查找,
+ *   再从采样节点向后查找, 长的查找经过的节点被加入索引. 存储方式的切换比构造时滞后, 避免在边界附近来回转换
+ * - add_terms()只对新的一批项排序合并, 再与已有的项线性归并
+ */
 class polynormial_function: protected linked_list<polynormial_item> {
 
 public:
 	// using linked_list<item_t> = linked_list<polynormial_item>;
 	using item_t = polynormial_item;
-	using linked_list<item_t>::iterator_t;
-	using linked_list<item_t>::const_iterator_t;
+	using terms_t = linked_list<item_t>;
+
+	struct const_iterator {
+		using value_type = item_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = item_t;
+		using pointer = void;
+		using iterator_category = std::input_iterator_tag;
+		using iterator_concept = std::forward_iterator_tag;
+
+	private:
+		terms_t::const_iterator_t it{nullptr}; //the node when it's sparse
+		const double* first = nullptr,         //coefs.data() when it's dense, pos == nullptr if it's sparse
+		            * pos = nullptr,
+		            * stop = nullptr;
+
+	public:
+		const_iterator() {}
+		const_iterator(terms_t::const_iterator_t it): it{it} {}
+		const_iterator(const double* first, const double* pos, const double* stop): first{first}, pos{pos}, stop{stop} {
+			while(this->pos != stop and *this->pos == 0) ++this->pos;
+		}
+		item_t operator*() const{return pos == nullptr ? *it : item_t{*pos, static_cast<size_t>(pos - first)}; }
+		const_iterator& operator++() {
+			if(pos == nullptr) ++it;
+			else do ++pos; while(pos != stop and *pos == 0);
+			return *this;
+		}
+		const_iterator operator++(int) {auto temp = *this; ++*this; return temp; }
+		bool operator==(const const_iterator& other) const noexcept{return it == other.it and pos == other.pos; }
+		bool operator!=(const const_iterator& other) const noexcept{return !(*this == other); }
+	};
+	using iterator_t = const_iterator;
+	using const_iterator_t = const_iterator;
 
-	using linked_list<item_t>::begin;
-	using linked_list<item_t>::end;
-	using linked_list<item_t>::length;
 private:
 
 	using linked_list<item_t>::head;
@@ -37,54 +115,833 @@ private:
 	using linked_list<item_t>::erase;
 	using linked_list<item_t>::node_t;
 	using linked_list<item_t>::merge;
+
+	//the crossovers of multiply_policy::automatic between the dense products, 
+	//on the coefficient count of the shorter operand, measured by benchmark.cpp
+	static constexpr size_t karatsuba_threshold = 40;
+	static constexpr size_t fft_threshold = 512;
+
+	//the doubles in a SIMD register of the target
+#if defined(__AVX512F__)
+	static constexpr size_t simd_doubles = 8;
+#elif defined(__AVX__)
+	static constexpr size_t simd_doubles = 4;
+#else
+	static constexpr size_t simd_doubles = 2;
+#endif
+	//the points of a batch of eval_many(), 4 independent chains of multiply-adds in each lane hide their latency
+	static constexpr size_t eval_batch = 4 * simd_doubles;
+	//eval_many() starts a worker thread for every so many points at most
+	static constexpr size_t eval_thread_points = 1 << 14;
+	//add_term() samples every sqrt(size()) / index_stride_divisor nodes of the sparse terms, but not closer than index_min_stride.
+	//the walk between the samples misses the cache on every node, so it's kept shorter than sqrt(size()) at the cost of longer index moves
+	static constexpr size_t index_stride_divisor = 16;
+	static constexpr size_t index_min_stride = 16;
+
+protected:
+
+	std::vector<double> coefs; //coefs[n] is the coefficient of x^n when it's dense
+	size_t dense_length = 0;   //the number of the nonzero coefficients when it's dense
+	bool dense = false;
+
+	//some nodes of the sparse terms in the order of n, so that add_term() skips to the neighbourhood of a term.
+	//it's built by add_term() and dropped by the other modifications, a copy of it is empty
+	struct term_index {
+		struct sample {
+			size_t n;  //the n of node, so the binary search doesn't touch the nodes
+			node_t* node;
+		};
+		std::vector<sample> nodes;
+		size_t stride = 0;        //the distance between the sampled nodes when it's built
+		size_t built_length = 0;  //the length of the terms when it's built, 0 if it's not built
+
+		term_index() noexcept{}
+		term_index(const term_index&) noexcept{}
+		term_index& operator=(const term_index&) noexcept{
+			clear();
+			return *this;
+		}
+		void clear() noexcept{
+			nodes.clear();
+			built_length = 0;
+		}
+	} index;
+
 public:
 
-	polynormial_function(const polyfunc& other): linked_list<item_t>(other.data()) {}
-	polynormial_function(polyfunc&& other): linked_list<item_t>(move(other.data())) {}
+	polynormial_function() {}
+	polynormial_function(const polyfunc& other) = default;
+	polynormial_function(polyfunc&& other) noexcept: linked_list<item_t>(static_cast<terms_t&&>(other)), coefs(move(other.coefs)), dense_length{other.dense_length}, dense{other.dense} {
+		other.dense_length = 0;
+		other.dense = false;
+		other.index.clear();
+	}
 
-	template <typename U> 
+	template <typename U>
 	requires same_as<remove_cvref_t<U>, linked_list<item_t>>
 	polynormial_function(U&& other): linked_list<item_t>(forward<U>(other)) {
 		regularize();
 	}
 	polynormial_function(initializer_list<item_t> list): linked_list<item_t>(list) {
-		regularize();	
+		regularize();
+	}
+
+	polynormial_function& operator=(const polyfunc& other) = default;
+	polynormial_function& operator=(polyfunc&& other) noexcept{
+		if(this == &other) return *this;
+		terms_t::operator=(static_cast<terms_t&&>(other));
+		coefs = move(other.coefs);
+		dense_length = other.dense_length;
+		dense = other.dense;
+		other.coefs.clear();
+		other.dense_length = 0;
+		other.dense = false;
+		index.clear();
+		other.index.clear();
+		return *this;
+	}
+
+	const_iterator_t begin() const noexcept{
+		if(dense) return {coefs.data(), coefs.data(), coefs.data() + coefs.size()};
+		return {terms_t::cbegin()};
+	}
+	const_iterator_t end() const noexcept{
+		if(dense) return {coefs.data(), coefs.data() + coefs.size(), coefs.data() + coefs.size()};
+		return {terms_t::cend()};
+	}
+
+	//the number of the nonzero terms
+	size_t size() const noexcept{return dense ? dense_length : length; }
+	bool is_empty() const noexcept{return size() == 0; }
+	bool is_dense() const noexcept{return dense; }
+
+	//0 if it's empty
+	size_t degree() const noexcept{
+		if(dense) return coefs.size() - 1;
+		return length == 0 ? 0 : terms_t::back().n;
 	}
 
 	void regularize() {
-		if(length == 0) return; 
-		sort([](const item_t& item1, const item_t& item2) noexcept{ return item1.n < item2.n; });
-		//merge same items
-		node_t** pos = &head;
-
-		while(*pos != nullptr and (*pos)->next != nullptr) {
-			if((*pos)->data.a == 0) erase(pos);
-			else if((*pos)->data.n == (*pos)->next->data.n) {
-				//merge the same n's item
-				(*pos)->data.a += (*pos)->next->data.a;
-				erase_after(iterator_t{*pos});
+		index.clear();
+		if(dense) {
+			trim();
+		}else if(length != 0) {
+			sort([](const item_t& item1, const item_t& item2) noexcept{ return item1.n < item2.n; });
+			//merge same items
+			node_t** pos = &head();
+
+			while(*pos != nullptr and (*pos)->next != nullptr) {
+				if((*pos)->data.a == 0) erase(pos);
+				else if((*pos)->data.n == (*pos)->next->data.n) {
+					//merge the same n's item
+					(*pos)->data.a += (*pos)->next->data.a;
+					erase_after(terms_t::iterator_t{*pos});
+				}else {
+					pos = &((*pos)->next);
+				}
+			}
+			if(*pos != nullptr and (*pos)->data.a == 0) erase(pos);
+		}
+		select_storage();
+	}
+
+	//the sparse terms, a dense polynormial is converted to the sparse storage first
+	linked_list<item_t>& data() {
+		index.clear();
+		if(dense) to_sparse();
+		return static_cast<linked_list<item_t>&>(*this);
+	}
+
+	//a copy of the terms, since a dense polynormial has no term list, the same as to_terms()
+	linked_list<item_t> data() const{
+		return to_terms();
+	}
+
+	//a copy of the nonzero terms, sorted by n
+	linked_list<item_t> to_terms() const{
+		return linked_list<item_t>(begin(), end());
+	}
+
+	//adds a * x^n in place, the terms stay sorted and combined.
+	//O(1) on the dense storage, O(sqrt(size())) amortized on the sparse storage
+	polyfunc& add_term(double a, size_t n) {
+		if(a == 0) return *this;
+		if(dense) {
+			if(n < coefs.size() or prefers_dense(dense_length + 1, n)) {
+				add_dense_term(a, n);
+				return *this;
+			}
+			to_sparse();
+		}
+		if(length == 0 or terms_t::back().n < n) {
+			//a stream in the order of n only appends
+			link(&(last->next), new_node(item_t{a, n}));
+		}else {
+			auto [pos, at] = find_link(n);
+			//*pos != nullptr since back().n >= n
+			if((*pos)->data.n == n) {
+				(*pos)->data.a += a;
+				if((*pos)->data.a == 0) {
+					if(at != index.nodes.end() and at->node == *pos) index.nodes.erase(at);
+					erase(pos);
+				}
 			}else {
-				pos = &((*pos)->next);
+				link(pos, new_node(item_t{a, n}));
 			}
 		}
-		if(*pos != nullptr and (*pos)->data.a == 0) erase(pos);
-	
-	}	
+		//later than select_storage(), so that a stream near the boundary doesn't convert back and forth
+		if(prefers_dense(length / 2, degree())) to_dense();
+		return *this;
+	}
 
-	linked_list<item_t>& data() noexcept{return static_cast<linked_list<item_t>&>(*this); }
-	const linked_list<item_t>& data() const noexcept{ return static_cast<const linked_list<item_t>&>(*this); }
+	//only the batch is sorted and combined, then it's merged into the terms in one pass: O(k * log(k) + size()) for k terms.
+	//a batch too small to pay for the pass over the terms is added by add_term() one by one
+	template <std::ranges::input_range RangeT>
+	requires convertible_to<std::ranges::range_reference_t<RangeT>, const item_t&>
+	polyfunc& add_terms(RangeT&& range) {
+		if constexpr(std::ranges::sized_range<RangeT>) {
+			size_t k = static_cast<size_t>(std::ranges::size(range));
+			if(k * index_stride(size()) < size()) {
+				for(const item_t& item: range) add_term(item.a, item.n);
+				return *this;
+			}
+		}
+		terms_t batch;
+		batch.append_range(forward<RangeT>(range));
+		return *this += polyfunc(move(batch));
+	}
+
+	//in place, like terms are combined and the zeros are dropped in one pass over both term lists, without sorting
+	polyfunc& operator+=(const polyfunc& other) {
+		add(other, 1);
+		return *this;
+	}
+	polyfunc& operator-=(const polyfunc& other) {
+		add(other, -1);
+		return *this;
+	}
+	//the nodes of other are relinked into *this if both are sparse, other becomes empty
+	polyfunc& operator+=(polyfunc&& other) {
+		add(move(other), 1);
+		return *this;
+	}
+	polyfunc& operator-=(polyfunc&& other) {
+		add(move(other), -1);
+		return *this;
+	}
 
-	//TODO...
 	friend polyfunc operator-(const polyfunc& f) {
-		auto temp = f;
-		
+		polyfunc temp = f;
+		temp.negate();
+		return temp;
+	}
+	friend polyfunc operator-(polyfunc&& f) {
+		f.negate();
+		return move(f);
 	}
- 
+
 	friend polyfunc operator+(const polyfunc& f1, const polyfunc& f2) {
-		return polyfunc(merge(f1.data(), f2.data(), [](const polyitem& a, const polyitem& b) noexcept{return a.n < b.n;} ));
+		polyfunc temp = f1;
+		temp += f2;
+		return temp;
+	}
+	friend polyfunc operator+(polyfunc&& f1, const polyfunc& f2) {
+		f1 += f2;
+		return move(f1);
+	}
+	friend polyfunc operator+(const polyfunc& f1, polyfunc&& f2) {
+		f2 += f1;
+		return move(f2);
+	}
+	friend polyfunc operator+(polyfunc&& f1, polyfunc&& f2) {
+		f1 += move(f2);
+		return move(f1);
 	}
+
 	friend polyfunc operator-(const polyfunc& f1, const polyfunc& f2) {
+		polyfunc temp = f1;
+		temp -= f2;
+		return temp;
+	}
+	friend polyfunc operator-(polyfunc&& f1, const polyfunc& f2) {
+		f1 -= f2;
+		return move(f1);
+	}
+	friend polyfunc operator-(const polyfunc& f1, polyfunc&& f2) {
+		f2.negate();
+		f2 += f1;
+		return move(f2);
+	}
+	friend polyfunc operator-(polyfunc&& f1, polyfunc&& f2) {
+		f1 -= move(f2);
+		return move(f1);
+	}
+
+	friend polyfunc operator*(const polyfunc& f1, const polyfunc& f2) {
+		return multiply(f1, f2);
+	}
+
+	polyfunc& operator*=(const polyfunc& other) {
+		return *this = multiply(*this, other);
+	}
+
+	//0 if it's empty
+	double eval(double x) const noexcept{
+		if(dense) {
+			//Horner's method
+			double r = 0;
+			for(size_t i = coefs.size(); i-- != 0; ) r = r * x + coefs[i];
+			return r;
+		}
+		//p is x^n of the current term, the gaps of n are powered by squaring
+		double r = 0, p = 1;
+		size_t last_n = 0;
+		for(const item_t& item: static_cast<const terms_t&>(*this)) {
+			p *= power(x, item.n - last_n);
+			last_n = item.n;
+			r += item.a * p;
+		}
+		return r;
+	}
+
+	//out[i] = eval(xs[i]) for i < min(xs.size(), out.size()), in batches of eval_batch points,
+	//threads > 1 splits the points among worker threads, threads == 0 means std::thread::hardware_concurrency()
+	void eval_many(std::span<const double> xs, std::span<double> out, size_t threads = 1) const{
+		size_t n = std::min(xs.size(), out.size());
+		if(n == 0) return;
+		if(is_empty()) {
+			std::fill_n(out.begin(), n, 0.0);
+			return;
+		}
+		//Horner's form, a[0] is the coefficient of the highest term, 
+		//r = r * x^gaps[t - 1] + a[t] for each t > 0, then r * x^low
+		std::vector<double> a;
+		std::vector<size_t> gaps;
+		size_t low = 0;
+		if(!dense) {
+			a.reserve(length);
+			gaps.reserve(length);
+			low = terms_t::front().n;
+			size_t last_n = low;
+			for(const item_t& item: static_cast<const terms_t&>(*this)) {
+				if(!a.empty()) gaps.push_back(item.n - last_n);
+				a.push_back(item.a);
+				last_n = item.n;
+			}
+			std::reverse(a.begin(), a.end());
+			std::reverse(gaps.begin(), gaps.end());
+		}
+		auto eval_range = [&](size_t first, size_t last) {
+			double x[eval_batch], r[eval_batch];
+			for(size_t i = first; i < last; i += eval_batch) {
+				size_t m = std::min(eval_batch, last - i);
+				//the last batch is padded with its first point
+				for(size_t j = 0; j < eval_batch; j++) x[j] = xs[i + (j < m ? j : 0)];
+				if(dense) horner_batch(coefs.data(), coefs.size(), x, r);
+				else horner_batch(a.data(), gaps.data(), a.size(), low, x, r);
+				std::copy_n(r, m, out.begin() + i);
+			}
+		};
+
+		if(threads == 0) threads = std::thread::hardware_concurrency();
+		threads = std::min(threads, (n + eval_thread_points - 1) / eval_thread_points);
+		if(threads <= 1) {
+			eval_range(0, n);
+			return;
+		}
+		//the slices are aligned to the batches
+		size_t batches = (n + eval_batch - 1) / eval_batch;
+		std::vector<std::jthread> workers;
+		workers.reserve(threads);
+		for(size_t i = 0; i < threads; i++) {
+			size_t first = std::min(n, batches * i / threads * eval_batch),
+			       last = std::min(n, batches * (i + 1) / threads * eval_batch);
+			workers.emplace_back(eval_range, first, last);
+		}
+	}
+
+	static polyfunc multiply(const polyfunc& f1, const polyfunc& f2, multiply_policy::automatic_t = {}) {
+		if(f1.is_empty() or f2.is_empty()) return {};
+		if(!f1.dense or !f2.dense) {
+			//the estimated costs in heap steps, measured by benchmark.cpp, 
+			//a step costs about 16 multiply-adds of schoolbook, or one n * log2(n) unit of FFT
+			double k = static_cast<double>(f1.size()), m = static_cast<double>(f2.size()),
+			       da = static_cast<double>(f1.degree()) + 1, db = static_cast<double>(f2.degree()) + 1,
+			       heap = k * m * std::log2(std::min(k, m) + 1),
+			       dense = std::min(da * db / 16, (da + db) * std::log2(da + db));
+			if(heap < dense) return multiply(f1, f2, multiply_policy::sparse);
+		}
+		size_t shorter = std::min(f1.degree(), f2.degree()) + 1;
+		if(shorter < karatsuba_threshold) return multiply(f1, f2, multiply_policy::schoolbook);
+		if(shorter < fft_threshold)       return multiply(f1, f2, multiply_policy::karatsuba);
+		return multiply(f1, f2, multiply_policy::fft);
+	}
+
+	//Johnson's algorithm, a heap holds the next product of each term of the shorter operand,
+	//the products are popped by increasing n, so that the like ones are adjacent
+	static polyfunc multiply(const polyfunc& f1, const polyfunc& f2, multiply_policy::sparse_t) {
+		if(f1.is_empty() or f2.is_empty()) return {};
+		std::vector<item_t> a(f1.begin(), f1.end()), 
+		                    b(f2.begin(), f2.end());
+		if(a.size() > b.size()) a.swap(b);
+
+		struct product {
+			size_t n, i, j; //a[i] * b[j], n == a[i].n + b[j].n
+		};
+		auto later = [](const product& x, const product& y) noexcept{return x.n > y.n; };
+		std::vector<product> heap;
+		auto replace_top = [&heap](product x) noexcept{
+			//one sift down instead of std::pop_heap and std::push_heap
+			size_t i = 0, n = heap.size();
+			for(size_t c = 1; c < n; c = 2 * i + 1) {
+				if(c + 1 < n and heap[c + 1].n < heap[c].n) c++;
+				if(x.n <= heap[c].n) break;
+				heap[i] = heap[c];
+				i = c;
+			}
+			heap[i] = x;
+		};
+		heap.reserve(a.size());
+		heap.push_back({a[0].n + b[0].n, 0, 0});
+
+		std::vector<item_t> items;
+		item_t current{0, a[0].n + b[0].n};
+		while(!heap.empty()) {
+			product p = heap.front();
+			if(p.n != current.n) {
+				if(current.a != 0) items.push_back(current);
+				current = {0, p.n};
+			}
+			current.a += a[p.i].a * b[p.j].a;
+			if(p.j + 1 < b.size()) {
+				replace_top({a[p.i].n + b[p.j + 1].n, p.i, p.j + 1});
+			}else {
+				std::pop_heap(heap.begin(), heap.end(), later);
+				heap.pop_back();
+			}
+			//a[i + 1] * b[0] is never earlier than a[i] * b[0], so it's pushed after a[i] * b[0] is popped
+			if(p.j == 0 and p.i + 1 < a.size()) {
+				heap.push_back({a[p.i + 1].n + b[0].n, p.i + 1, 0});
+				std::push_heap(heap.begin(), heap.end(), later);
+			}
+		}
+		if(current.a != 0) items.push_back(current);
+
+		polyfunc temp;
+		temp.append_n(items.begin(), items.size());
+		temp.select_storage();
+		return temp;
+	}
+
+	static polyfunc multiply(const polyfunc& f1, const polyfunc& f2, multiply_policy::schoolbook_t) {
+		if(f1.is_empty() or f2.is_empty()) return {};
+		std::vector<double> temp1, temp2;
+		std::span<const double> a = f1.dense_coefs(temp1), 
+		                        b = f2.dense_coefs(temp2);
+		std::vector<double> c(a.size() + b.size() - 1, 0.0);
+		schoolbook_product(a.data(), a.size(), b.data(), b.size(), c.data());
+		return from_coefs(move(c));
+	}
+
+	static polyfunc multiply(const polyfunc& f1, const polyfunc& f2, multiply_policy::karatsuba_t) {
+		if(f1.is_empty() or f2.is_empty()) return {};
+		std::vector<double> temp1, temp2;
+		std::span<const double> a = f1.dense_coefs(temp1), 
+		                        b = f2.dense_coefs(temp2);
+		std::vector<double> c(a.size() + b.size() - 1, 0.0);
+		dense_product(a.data(), a.size(), b.data(), b.size(), c.data());
+		return from_coefs(move(c));
+	}
+
+	static polyfunc multiply(const polyfunc& f1, const polyfunc& f2, multiply_policy::fft_t) {
+		if(f1.is_empty() or f2.is_empty()) return {};
+		std::vector<double> temp1, temp2;
+		return from_coefs(fft_product(f1.dense_coefs(temp1), f2.dense_coefs(temp2)));
+	}
+
+protected:
+
+	static bool prefers_dense(size_t nonzero, size_t degree) noexcept{
+		//(degree + 1) * sizeof(double) <= nonzero * sizeof(node_t), without the overflow of degree + 1 for a huge degree
+		return degree < nonzero * sizeof(node_t) / sizeof(double);
+	}
+
+	void select_storage() {
+		if(dense) {
+			if(!prefers_dense(dense_length, coefs.size() - 1)) to_sparse();
+		}else if(prefers_dense(length, degree())) {
+			to_dense();
+		}
+	}
+
+	//drops the zeros on the back and counts the nonzero coefficients
+	void trim() noexcept{
+		while(!coefs.empty() and coefs.back() == 0) coefs.pop_back();
+		dense_length = 0;
+		for(double a: coefs) dense_length += a != 0;
+	}
+
+	void to_dense() {
+		//the terms are sorted and nonzero
+		index.clear();
+		coefs.assign(degree() + 1, 0.0);
+		for(const item_t& item: static_cast<const terms_t&>(*this)) coefs[item.n] = item.a;
+		dense_length = length;
+		terms_t::clear();
+		dense = true;
+	}
+
+	void to_sparse() {
+		//the nodes are allocated in one block
+		index.clear();
+		terms_t::clear();
+		append_n(begin(), dense_length);
+		std::vector<double>().swap(coefs);
+		dense_length = 0;
+		dense = false;
+	}
+
+	void negate() noexcept{
+		if(dense) for(double& a: coefs) a = -a;
+		else for(item_t& item: static_cast<terms_t&>(*this)) item.a = -item.a;
+	}
+
+	//*this += sign * other
+	void add(const polyfunc& other, double sign) {
+		if(other.is_empty()) return;
+		index.clear();
+		if(this == &other) {
+			if(sign > 0) {
+				if(dense) for(double& a: coefs) a += a;
+				else for(item_t& item: static_cast<terms_t&>(*this)) item.a += item.a;
+			}else {
+				*this = polyfunc{};
+			}
+			return;
+		}
+		size_t max_degree = std::max(degree(), other.degree());
+		//the storage which the sum would choose, if no term is cancelled
+		if(dense != prefers_dense(size() + other.size(), max_degree)) {
+			if(dense) to_sparse();
+			else to_dense();
+		}
+
+		if(dense) {
+			//max_degree + 1 doesn't overflow, since the dense storage is preferred
+			if(coefs.size() <= max_degree) coefs.resize(max_degree + 1, 0.0);
+			if(other.dense) {
+				double* a = coefs.data();
+				const double* b = other.coefs.data();
+				for(size_t i = 0, m = other.coefs.size(); i < m; i++) a[i] += sign * b[i];
+			}else {
+				for(const item_t& item: static_cast<const terms_t&>(other)) coefs[item.n] += sign * item.a;
+			}
+			trim();
+		}else {
+			//pos only moves forward, since the terms of both are sorted
+			node_t** pos = &head();
+			for(const item_t item: other) {
+				while(*pos != nullptr and (*pos)->data.n < item.n) pos = &((*pos)->next);
+				if(*pos != nullptr and (*pos)->data.n == item.n) {
+					(*pos)->data.a += sign * item.a;
+					if((*pos)->data.a == 0) erase(pos);
+					else pos = &((*pos)->next);
+				}else {
+					link(pos, new_node(item_t{sign * item.a, item.n}));
+					pos = &((*pos)->next);
+				}
+			}
+		}
+		select_storage();
+	}
+
+	void add(polyfunc&& other, double sign) {
+		if(this == &other or dense or other.dense) {
+			add(static_cast<const polyfunc&>(other), sign);
+			return;
+		}
+		//the nodes of other might be kept as the spare nodes of *this
+		index.clear();
+		blocks.share(other.blocks);
+		node_t** pos = &head();
+		node_t* node = other.head();
+		while(node != nullptr) {
+			node_t* next = node->next;
+			while(*pos != nullptr and (*pos)->data.n < node->data.n) pos = &((*pos)->next);
+			if(*pos != nullptr and (*pos)->data.n == node->data.n) {
+				(*pos)->data.a += sign * node->data.a;
+				delete_node(node);
+				if((*pos)->data.a == 0) erase(pos);
+				else pos = &((*pos)->next);
+			}else {
+				node->data.a *= sign;
+				link(pos, node);
+				pos = &(node->next);
+			}
+			node = next;
+		}
+		other.head() = nullptr;
+		other.last = &other.before_head;
+		other.length = 0;
+		other.index.clear();
+		select_storage();
+	}
+
+	void link(node_t** pos, node_t* node) noexcept{
+		//link node in front of *pos, where *pos might be nullptr
+		node->next = *pos;
+		if(*pos == nullptr) last = node;
+		*pos = node;
+		length++;
+	}
+
+	void add_dense_term(double a, size_t n) {
+		if(n >= coefs.size()) coefs.resize(n + 1, 0.0);
+		double& c = coefs[n];
+		dense_length -= c != 0;
+		c += a;
+		dense_length += c != 0;
+		while(!coefs.empty() and coefs.back() == 0) coefs.pop_back();
+		//later than select_storage() as add_term()
+		if(dense_length == 0 or !prefers_dense(2 * dense_length, coefs.size() - 1)) to_sparse();
+	}
+
+	static size_t index_stride(size_t length) noexcept{
+		return std::max(index_min_stride, static_cast<size_t>(std::sqrt(static_cast<double>(length))) / index_stride_divisor);
+	}
+
+	void build_index() {
+		index.nodes.clear();
+		index.built_length = length;
+		index.stride = index_stride(length);
+		size_t i = 0;
+		for(node_t* node = head(); node != nullptr; node = node->next) {
+			if(++i % index.stride == 0) index.nodes.push_back({node->data.n, node});
+		}
+	}
+
+	//the link to the first node whose n is not less than n, and the first sampled node whose n is not less than n.
+	//the index is rebuilt when the length is doubled or halved, the nodes passed by a long walk are sampled
+	std::pair<node_t**, std::vector<term_index::sample>::iterator> find_link(size_t n) {
+		if(index.built_length == 0 or length > 2 * index.built_length or 2 * length < index.built_length) build_index();
+		std::vector<term_index::sample>& nodes = index.nodes;
+		auto at = std::partition_point(nodes.begin(), nodes.end(), [n](const term_index::sample& sample) noexcept{return sample.n < n; });
+		node_t** pos = at == nodes.begin() ? &head() : &((at - 1)->node->next);
+		std::vector<term_index::sample> passed;
+		for(size_t steps = 1; *pos != nullptr and (*pos)->data.n < n; steps++) {
+			if(steps % index.stride == 0) passed.push_back({(*pos)->data.n, *pos});
+			pos = &((*pos)->next);
+		}
+		if(!passed.empty()) {
+			size_t offset = at - nodes.begin();
+			nodes.insert(at, passed.begin(), passed.end());
+			at = nodes.begin() + offset + passed.size();
+		}
+		return {pos, at};
+	}
+
+	std::span<const double> dense_coefs(std::vector<double>& temp) const{
+		//the coefficients of a sparse polynormial are copied into temp
+		if(dense) return coefs;
+		if(degree() >= temp.max_size()) throw std::length_error("polynormial_function: the degree is too large for the coefficient array");
+		temp.assign(degree() + 1, 0.0);
+		for(const item_t& item: static_cast<const terms_t&>(*this)) temp[item.n] = item.a;
+		return temp;
+	}
 
+	static double power(double x, size_t n) noexcept{
+		//by squaring
+		double r = 1;
+		for(; n != 0; n >>= 1) {
+			if(n & 1) r *= x;
+			x *= x;
+		}
+		return r;
+	}
+
+	//the lanes are independent, so that each loop over them can be vectorized
+	static void horner_batch(const double* c, size_t n, const double* x, double* r) noexcept{
+		//dense, c[n - 1] is the highest coefficient
+		for(size_t j = 0; j < eval_batch; j++) r[j] = c[n - 1];
+		for(size_t i = n - 1; i-- != 0; ) {
+			double ci = c[i];
+			for(size_t j = 0; j < eval_batch; j++) r[j] = r[j] * x[j] + ci;
+		}
+	}
+
+	static void horner_batch(const double* a, const size_t* gaps, size_t n, size_t low, const double* x, double* r) noexcept{
+		//sparse, the powers of the gaps are computed by squaring in all the lanes together
+		double p[eval_batch], b[eval_batch];
+		auto powers = [&p, &b, x](size_t e) noexcept{
+			for(size_t j = 0; j < eval_batch; j++) {
+				p[j] = 1;
+				b[j] = x[j];
+			}
+			for(; e != 0; e >>= 1) {
+				if(e & 1) for(size_t j = 0; j < eval_batch; j++) p[j] *= b[j];
+				if(e > 1) for(size_t j = 0; j < eval_batch; j++) b[j] *= b[j];
+			}
+		};
+		for(size_t j = 0; j < eval_batch; j++) r[j] = a[0];
+		for(size_t t = 1; t < n; t++) {
+			double at = a[t];
+			if(gaps[t - 1] == 1) {
+				for(size_t j = 0; j < eval_batch; j++) r[j] = r[j] * x[j] + at;
+			}else {
+				powers(gaps[t - 1]);
+				for(size_t j = 0; j < eval_batch; j++) r[j] = r[j] * p[j] + at;
+			}
+		}
+		if(low != 0) {
+			powers(low);
+			for(size_t j = 0; j < eval_batch; j++) r[j] *= p[j];
+		}
+	}
+
+	static polyfunc from_coefs(std::vector<double>&& coefs) {
+		polyfunc temp;
+		temp.coefs = move(coefs);
+		temp.dense = true;
+		temp.regularize();
+		return temp;
+	}
+
+	static void schoolbook_product(const double* a, size_t na, const double* b, size_t nb, double* c) noexcept{
+		//c[0, na + nb - 1) += a * b, the inner loop can be vectorized
+		for(size_t i = 0; i < na; i++) {
+			double ai = a[i];
+			double* ci = c + i;
+			for(size_t j = 0; j < nb; j++) ci[j] += ai * b[j];
+		}
+	}
+
+	static void karatsuba_product(const double* a, const double* b, size_t n, double* c) {
+		//c[0, 2n - 1) += a * b, where a and b have n coefficients
+		if(n < karatsuba_threshold) {
+			schoolbook_product(a, n, b, n, c);
+			return;
+		}
+		//a = a0 + a1 * x^m, b = b0 + b1 * x^m, a * b = z0 + (z1 - z0 - z2) * x^m + z2 * x^2m,
+		//where z0 = a0 * b0, z2 = a1 * b1, z1 = (a0 + a1) * (b0 + b1)
+		size_t m = n / 2, 
+		       h = n - m;
+		std::vector<double> buffer(2 * h + 3 * (2 * h - 1), 0.0);
+		double* sa = buffer.data(),
+		      * sb = sa + h,
+		      * z0 = sb + h,
+		      * z1 = z0 + (2 * h - 1),
+		      * z2 = z1 + (2 * h - 1);
+		for(size_t i = 0; i < m; i++) {
+			sa[i] = a[i] + a[m + i];
+			sb[i] = b[i] + b[m + i];
+		}
+		if(h != m) {
+			sa[m] = a[n - 1];
+			sb[m] = b[n - 1];
+		}
+		karatsuba_product(a, b, m, z0);
+		karatsuba_product(a + m, b + m, h, z2);
+		karatsuba_product(sa, sb, h, z1);
+		for(size_t i = 0; i < 2 * m - 1; i++) z1[i] -= z0[i];
+		for(size_t i = 0; i < 2 * h - 1; i++) z1[i] -= z2[i];
+		for(size_t i = 0; i < 2 * m - 1; i++) c[i] += z0[i];
+		for(size_t i = 0; i < 2 * h - 1; i++) c[m + i] += z1[i];
+		for(size_t i = 0; i < 2 * h - 1; i++) c[2 * m + i] += z2[i];
+	}
+
+	static void dense_product(const double* a, size_t na, const double* b, size_t nb, double* c) {
+		//c[0, na + nb - 1) += a * b, the longer operand is cut into the pieces as long as the shorter one for Karatsuba
+		if(na < nb) {
+			std::swap(a, b);
+			std::swap(na, nb);
+		}
+		if(nb < karatsuba_threshold) {
+			schoolbook_product(a, na, b, nb, c);
+			return;
+		}
+		for(size_t i = 0; i < na; i += nb) {
+			if(na - i >= nb) karatsuba_product(a + i, b, nb, c + i);
+			else dense_product(b, nb, a + i, na - i, c + i);
+		}
+	}
+
+	static std::complex<double> complex_product(std::complex<double> x, std::complex<double> y) noexcept{
+		//without the NaN checks of std::complex's operator*
+		return {x.real() * y.real() - x.imag() * y.imag(), x.real() * y.imag() + x.imag() * y.real()};
+	}
+
+	static void fft(std::vector<std::complex<double>>& x, bool inverse) {
+		//iterative radix-2, x.size() is a power of 2, the inverse one is not divided by x.size()
+		size_t n = x.size();
+		for(size_t i = 1, j = 0; i < n; i++) {
+			size_t bit = n >> 1;
+			for(; j & bit; bit >>= 1) j ^= bit;
+			j ^= bit;
+			if(i < j) std::swap(x[i], x[j]);
+		}
+		//each root is computed directly rather than by repeated multiplication, which keeps the error bound
+		std::vector<std::complex<double>> roots(n / 2);
+		for(size_t k = 0; k < n / 2; k++) {
+			double angle = (inverse ? 2 : -2) * std::numbers::pi * static_cast<double>(k) / static_cast<double>(n);
+			roots[k] = {std::cos(angle), std::sin(angle)};
+		}
+		for(size_t len = 2; len <= n; len <<= 1) {
+			size_t half = len / 2, 
+			       step = n / len;
+			for(size_t i = 0; i < n; i += len) {
+				for(size_t k = 0; k < half; k++) {
+					std::complex<double> u = x[i + k], 
+					                     v = complex_product(x[i + k + half], roots[k * step]);
+					x[i + k] = u + v;
+					x[i + k + half] = u - v;
+				}
+			}
+		}
+	}
+
+	static std::vector<double> fft_product(std::span<const double> a, std::span<const double> b) {
+		//a and b are packed into one complex sequence p = a + i * s * b, which needs one forward and one inverse transform,
+		//s is a power of 2 which makes the norms of a and s * b close, so that the packing keeps the accuracy of the smaller one
+		std::vector<double> c(a.size() + b.size() - 1, 0.0);
+		double norm_a = 0, norm_b = 0;
+		for(double v: a) norm_a += v * v;
+		for(double v: b) norm_b += v * v;
+		if(norm_a == 0 or norm_b == 0) return c;
+		norm_a = std::sqrt(norm_a);
+		norm_b = std::sqrt(norm_b);
+		int shift = std::ilogb(norm_a) - std::ilogb(norm_b);
+		double scale = std::ldexp(1.0, shift);
+
+		size_t n = std::bit_ceil(c.size());
+		std::vector<std::complex<double>> p(n), q(n);
+		for(size_t i = 0; i < a.size(); i++) p[i].real(a[i]);
+		for(size_t i = 0; i < b.size(); i++) p[i].imag(std::ldexp(b[i], shift));
+		fft(p, false);
+		//A[k] = (P[k] + conj(P[n - k])) / 2, B[k] = (P[k] - conj(P[n - k])) / 2i, 
+		//so A[k] * B[k] = (P[k]^2 - conj(P[n - k])^2) / 4i
+		for(size_t k = 0; k < n; k++) {
+			std::complex<double> x = p[k], 
+			                     y = std::conj(p[(n - k) & (n - 1)]);
+			q[k] = complex_product(complex_product(x, x) - complex_product(y, y), {0, -0.25});
+		}
+		fft(q, true);
+		double unscale = std::ldexp(1.0 / static_cast<double>(n), -shift);
+		for(size_t i = 0; i < c.size(); i++) c[i] = q[i].real() * unscale;
+
+		//Percival's bound of the FFT convolution error, ||x|| * ||y|| * eps * (12 * log2(n) + 3) after linearization, 
+		//for the packed sequence, plus the error of unpacking
+		double eps = std::numeric_limits<double>::epsilon(),
+		       bound = (norm_a * norm_a + scale * norm_b * scale * norm_b) / scale * eps * (12.0 * std::bit_width(n) + 8);
+		auto integral = [](std::span<const double> v) {
+			for(double x: v) if(x != std::nearbyint(x) or std::fabs(x) > 0x1p53) return false;
+			return true;
+		};
+		if(bound < 0.5 and integral(a) and integral(b)) {
+			for(double& x: c) x = std::nearbyint(x);
+		}else {
+			for(double& x: c) if(std::fabs(x) <= bound) x = 0;
+		}
+		return c;
 	}
 
 };
@@ -107,11 +964,65 @@ std::ostream& operator<<(std::ostream& os, const polynormial_function& func) {
 } //namespace rais::study
 
 void test_polynormial_function() {
+	using namespace rais::study;
+
 	polyfunc func1 = {{0, 34}, {2, 3}, {18, 3}, {8, 1}, {9, 4}, {0, 2}, {4, 1}, {1, 2}},
 	     func2 = {{0, 3}, {13, 2}, {18, 2}, {8, 0}, {9, 4}, {0, 2}, {4, 1}, {1, 2}};
 	std::cout << "func1: " << func1 << '\n';
 	std::cout << "func2: " << func2 << '\n';
 	std::cout << "func1 + func2: " << (func1 + func2) << '\n';
 
+	polyfunc func3 = {{1, 1000}, {-2, 3}, {5, 0}};
+	std::cout << std::boolalpha << "dense: " << func1.is_dense() << ", " << func3.is_dense() << '\n';
+	std::cout << "func1 + func3: " << (func1 + func3) << ", degree: " << (func1 + func3).degree() << ", size: " << (func1 + func3).size() << '\n';
+	polyfunc func4 = {{-12, 1}, {-1, 2}, {-20, 3}, {-9, 4}};
+	std::cout << "func1 + func4: " << (func1 + func4) << ", size: " << (func1 + func4).size() << '\n';
 
-}
\ No newline at end of file
+	std::cout << "func1 * func2: " << (func1 * func2) << '\n';
+	std::cout << "func1 * func3: " << (func1 * func3) << '\n';
+	linked_list<polyitem> terms;
+	for(size_t i = 0; i < 1000; i++) terms.push(polyitem{static_cast<double>(i % 7) - 3, i});
+	polyfunc func5(std::move(terms)), product = func5 * func5;
+	auto equal = [](const polyfunc& f, const polyfunc& g) {
+		auto i = f.begin(), j = g.begin();
+		for(; i != f.end() and j != g.end(); ++i, ++j) if((*i).n != (*j).n or (*i).a != (*j).a) return false;
+		return i == f.end() and j == g.end();
+	};
+	std::cout << "multiply policies: " << equal(product, polyfunc::multiply(func5, func5, multiply_policy::schoolbook)) << ", "
+	          << equal(product, polyfunc::multiply(func5, func5, multiply_policy::karatsuba)) << ", "
+	          << equal(product, polyfunc::multiply(func5, func5, multiply_policy::sparse)) << ", "
+	          << equal(func1 * func3, polyfunc::multiply(func1, func3, multiply_policy::fft)) << ", size: " << product.size() << '\n';
+	func5 *= func3;
+	std::cout << "func5 *= func3: " << func5.size() << ", degree: " << func5.degree() << ", dense: " << func5.is_dense() << '\n';
+
+	double xs[] = {-1, 0, 0.5, 1, 2}, out[5];
+	func3.eval_many(xs, out);
+	std::cout << "func1(2): " << func1.eval(2) << ", func3(0.5): " << func3.eval(0.5) << ", func3.eval_many: ";
+	for(double y: out) std::cout << y << ' ';
+	std::cout << '\n';
+
+	polyfunc func6 = func1;
+	func6 += func3;
+	func6 -= func1;
+	std::cout << "func1 + func3 - func1: " << func6 << ", equal to func3: " << equal(func6, func3) << '\n';
+	std::cout << "-func3: " << -func3 << ", func1 - func2: " << (func1 - func2) << '\n';
+	polyfunc func7 = func2;
+	func6 = polyfunc(func1) + polyfunc(func2);
+	func7 += polyfunc(func1);
+	std::cout << "rvalue sums: " << equal(func6, func1 + func2) << ", " << equal(func7, func1 + func2) << ", " << equal(func2 - polyfunc(func1), -(func1 - func2)) << '\n';
+	func6 -= func6;
+	std::cout << "func6 -= func6: " << func6.is_empty() << '\n';
+
+	polyfunc func8;
+	linked_list<polyitem> stream;
+	for(size_t i = 0; i < 1000; i++) {
+		polyitem item{static_cast<double>(i % 7) - 3, (i * 7919) % 100003 % 5000};
+		func8.add_term(item.a, item.n);
+		stream.push(item);
+	}
+	std::vector<polyitem> items = {{1, 2}, {-3, 3}, {1, 1500}, {2, 2}, {4, 1000}, {-1, 1500}};
+	func7 = func1;
+	func7.add_terms(items).add_term(-3, 2).add_term(-4, 1000);
+	std::cout << "add_term: " << equal(func8, polyfunc(std::move(stream))) << ", size: " << func8.size() << ", dense: " << func8.is_dense() << '\n';
+	std::cout << "add_terms: " << func7 << ", equal to func1 - 3x^(3): " << equal(func7, func1 - polyfunc{{3, 3}}) << '\n';
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+//software prefetching of the node traversals of linked_list and double_list
+
+#include <cstddef>
+#include <concepts>
+
+#if defined(_MSC_VER) and !defined(__clang__) and (defined(_M_X64) or defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace rais::study {
+
+using std::size_t;
+
+//prefetch policies, the last template parameter of linked_list and double_list
+namespace prefetch_policy {
+	//no prefetching
+	struct none {
+		static constexpr size_t distance = 0;
+	};
+
+	//prefetches the node which is Distance nodes ahead of the traversal
+	template <size_t Distance = 8>
+	struct ahead {
+		static constexpr size_t distance = Distance;
+	};
+} //namespace prefetch_policy
+
+template <typename PolicyT>
+concept prefetch_policy_type = requires {
+	{PolicyT::distance}->std::convertible_to<size_t>;
+};
+
+inline void prefetch(const void* address) noexcept{
+#if defined(__GNUC__) or defined(__clang__)
+	__builtin_prefetch(address);
+#elif defined(_MSC_VER) and (defined(_M_X64) or defined(_M_IX86))
+	_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+	(void)address;
+#endif
+}
+
+
+/*
+ * 链表遍历的预取器.
+ * - 维护一个领先遍历位置Distance个节点的指针, 每一步前进一个节点并预取它到达的节点,
+ *   领先指针的访存缺失与遍历位置上的计算互相独立, 因此可以被乱序执行重叠
+ * - 构造时从first开始前进Distance个节点; 领先指针只读取尚未被遍历的节点的next,
+ *   因此遍历可以重新链接已经访问过的节点
+ * - Distance == 0时为空操作
+ */
+template <typename NodeT, size_t Distance>
+class node_prefetcher {
+	const NodeT* ahead;
+
+public:
+	explicit node_prefetcher(const NodeT* first) noexcept: ahead{first} {
+		for(size_t i = 0; i < Distance; i++) step();
+	}
+
+	//called once for each node the traversal leaves, 
+	//the node which ahead points to was prefetched one step before, so reading its next is likely a hit
+	void step() noexcept{
+		if(ahead == nullptr) return;
+		ahead = ahead->next;
+		if(ahead != nullptr) prefetch(ahead);
+	}
+};
+
+template <typename NodeT>
+class node_prefetcher<NodeT, 0> {
+public:
+	explicit node_prefetcher(const NodeT*) noexcept{}
+	void step() noexcept{}
+};
+
+} //namespace rais::study
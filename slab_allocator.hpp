@@ -0,0 +1,188 @@
+#pragma once
+
+//slab allocator for node based containers, such as linked_list and double_list
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+
+namespace rais::study {
+
+using std::size_t;
+using std::byte;
+using std::max_align_t;
+using std::align_val_t;
+using std::shared_ptr;
+using std::make_shared;
+using std::true_type;
+using std::false_type;
+
+/*
+ * 分级定长内存池.
+ * - 单对象分配按大小(对齐到指针大小)分为若干级(size class), 每一级从各自的大块内存(block)中顺序切出定长的槽(slot)
+ * - 不同类型的对象(如链表节点与其他簿记结构)落在不同的级中, 不会互相抢占槽的大小
+ * - 释放的槽挂入所在级的空闲链表(free list), 下次分配同级对象时优先复用
+ * - 只有在内存池析构时才会释放所有的块
+ * - 超过max_slot_size或超过max_align_t对齐的分配, 以及数组的分配直接转发给 ::operator new
+ * - 非线程安全: 分配器的所有拷贝(包括rebind后的拷贝)共享同一个内存池, 使用它们的容器不能被多个线程同时修改
+ */
+class slab_pool {
+
+	struct slot {
+		slot* next;
+	};
+	struct block {
+		block* next;
+	};
+	struct size_class {
+		slot* free_slots = nullptr;
+		byte* cursor = nullptr,    //the next unused slot of the current block
+		    * block_end = nullptr;
+	};
+
+	//slots start right after the block header, keep them aligned to max_align_t
+	static constexpr size_t header_size = (sizeof(block) + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+
+	//the larger objects are allocated by ::operator new
+	static constexpr size_t max_slot_size = 256;
+
+	size_t slots_per_block;
+	size_t live_slots = 0;
+	block* blocks = nullptr;
+	size_class classes[max_slot_size / sizeof(slot)];
+
+public:
+
+	explicit slab_pool(size_t slots_per_block) noexcept: slots_per_block{slots_per_block == 0 ? 1 : slots_per_block} {}
+	slab_pool(const slab_pool&) = delete;
+	slab_pool& operator=(const slab_pool&) = delete;
+	~slab_pool() {
+		while(blocks != nullptr) {
+			block* temp = blocks->next;
+			::operator delete(static_cast<void*>(blocks));
+			blocks = temp;
+		}
+	}
+
+	void* allocate(size_t size, size_t align) {
+		if(!is_slot(size, align)) return ::operator new(size, align_val_t{align});
+
+		size_t slot_size = slot_size_of(size, align);
+		size_class& c = classes[slot_size / sizeof(slot) - 1];
+		void* temp;
+		if(c.free_slots != nullptr) {
+			//recycle
+			temp = c.free_slots;
+			c.free_slots = c.free_slots->next;
+		}else {
+			if(c.cursor == c.block_end) new_block(c, slot_size);
+			temp = c.cursor;
+			c.cursor += slot_size;
+		}
+		live_slots++;
+		return temp;
+	}
+
+	void deallocate(void* p, size_t size, size_t align) noexcept{
+		if(!is_slot(size, align)) {
+			::operator delete(p, align_val_t{align});
+			return;
+		}
+		size_class& c = classes[slot_size_of(size, align) / sizeof(slot) - 1];
+		c.free_slots = ::new(p) slot{c.free_slots};
+		live_slots--;
+	}
+
+	size_t block_count() const noexcept{
+		size_t count = 0;
+		for(const block* pos = blocks; pos != nullptr; pos = pos->next) count++;
+		return count;
+	}
+
+	//the slots which are allocated and not deallocated yet
+	size_t slot_count() const noexcept{return live_slots; }
+
+protected:
+
+	static size_t slot_size_of(size_t size, size_t align) noexcept{
+		//a freed slot should be able to hold the free list link,
+		//the slots are multiples of align from an aligned block start, so they are all aligned
+		if(size < sizeof(slot)) size = sizeof(slot);
+		if(align < alignof(slot)) align = alignof(slot);
+		size = (size + align - 1) / align * align;
+		return (size + sizeof(slot) - 1) / sizeof(slot) * sizeof(slot);
+	}
+
+	static bool is_slot(size_t size, size_t align) noexcept{
+		return align <= alignof(max_align_t) and size <= max_slot_size;
+	}
+
+	void new_block(size_class& c, size_t slot_size) {
+		byte* memory = static_cast<byte*>(::operator new(header_size + slots_per_block * slot_size));
+		blocks = ::new(memory) block{blocks};
+		c.cursor = memory + header_size;
+		c.block_end = c.cursor + slots_per_block * slot_size;
+	}
+
+}; //class slab_pool
+
+
+/*
+ * 基于slab_pool的分配器.
+ * - 分配器的拷贝(包括rebind后的拷贝)共享同一个内存池
+ * - 容器拷贝构造时会得到一个新的内存池, 即每个链表拥有各自的空闲链表
+ * - 移动赋值与交换时内存池随节点一起转移
+ */
+template <typename T, size_t BlockSlots = 4096>
+class slab_allocator {
+
+	template <typename U, size_t>
+	friend class slab_allocator;
+
+	shared_ptr<slab_pool> pool;
+
+public:
+
+	using value_type = T;
+	using propagate_on_container_copy_assignment = false_type;
+	using propagate_on_container_move_assignment = true_type;
+	using propagate_on_container_swap = true_type;
+	using is_always_equal = false_type;
+
+	template <typename U>
+	struct rebind {
+		using other = slab_allocator<U, BlockSlots>;
+	};
+
+	slab_allocator(): pool{make_shared<slab_pool>(BlockSlots)} {}
+	//no move constructor, a moved allocator should still be usable
+	slab_allocator(const slab_allocator&) noexcept = default;
+	slab_allocator& operator=(const slab_allocator&) noexcept = default;
+	template <typename U>
+	slab_allocator(const slab_allocator<U, BlockSlots>& other) noexcept: pool{other.pool} {}
+
+	slab_allocator select_on_container_copy_construction() const{
+		return {};
+	}
+
+	T* allocate(size_t n) {
+		if(n != 1) return static_cast<T*>(::operator new(n * sizeof(T), align_val_t{alignof(T)}));
+		return static_cast<T*>(pool->allocate(sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* p, size_t n) noexcept{
+		if(n != 1) ::operator delete(p, align_val_t{alignof(T)});
+		else pool->deallocate(p, sizeof(T), alignof(T));
+	}
+
+	const slab_pool& get_pool() const noexcept{return *pool; }
+
+	template <typename U>
+	friend bool operator==(const slab_allocator& a, const slab_allocator<U, BlockSlots>& b) noexcept{
+		return a.pool == b.pool;
+	}
+
+}; //class slab_allocator<T, BlockSlots>
+
+} //namespace rais::study
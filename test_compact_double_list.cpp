@@ -0,0 +1,110 @@
+#include <list>
+#include <chrono>
+#include <random>
+#include <string>
+#include <iostream>
+#include <double_list.hpp>
+#include <compact_double_list.hpp>
+
+void test_compact_double_list() {
+	using namespace rais::study;
+	using std::cout;
+	constexpr char lf = '\n';
+	compact_double_list<int> list = {9, 6, 4, 1, 3, 2, 2, 3, 8, 4, 5 ,22, 18, 6, 5};
+	cout << list << ", node size: " << sizeof(compact_double_list<int>::node_t) << lf;
+	cout << list.push(11).unshift(22) << lf << list[0] << ", " << list[1] << ", " << list[list.size() - 1] << ", " << list[7] << lf;
+	list.clear();
+	cout << list << ", capacity: " << list.capacity() << lf;
+	compact_double_list<std::string> slist = {"slist", "test", "a", "bb", "ccc", "rais", "@@"};
+	cout << slist << lf;
+	slist.insert(2, "insert str");
+	slist.insert(0, "insert head");
+	cout << slist << lf;
+	cout << slist.shift() << lf << slist.pop() << lf << slist << lf;
+	slist.erase(3);
+	// the erased node is reused
+	slist.insert(++slist.begin(), "reused");
+	cout << slist << ", capacity: " << slist.capacity() << lf << "reverse list: \n";
+	slist.reverse();
+	cout << slist << ", back: " << slist.back() << lf;
+	// push a reference to its own element while growing
+	for(int i = 0; i < 20; i++) slist.push(slist.front());
+	auto slist2 = slist;
+	cout << "copy: " << slist2.size() << ", " << slist2.back() << ", capacity: " << slist2.capacity() << lf;
+
+	// compare with std::list under random operations
+	std::minstd_rand randint{42};
+	compact_double_list<int> list2;
+	std::list<int> std_list;
+	bool same = true;
+	for(int i = 0; i < 20000; i++) {
+		size_t op = randint() % 6,
+		       index = std_list.size() == 0 ? 0 : randint() % std_list.size();
+		if(op < 2 or std_list.size() == 0) {
+			list2.insert(index, i);
+			std_list.insert(std::next(std_list.begin(), index), i);
+		}else if(op == 2) {
+			list2.erase(index);
+			std_list.erase(std::next(std_list.begin(), index));
+		}else if(op == 3) {
+			list2.unshift(list2.shift() + 1);
+			std_list.front()++;
+		}else if(op == 4 and i % 1000 == 0) {
+			list2.reverse();
+			std_list.reverse();
+		}else {
+			same = same and list2[index] == *std::next(std_list.begin(), index);
+		}
+	}
+	for(auto it = std_list.begin(); int i: list2) same = same and i == *it++;
+	cout << "random operations: " << std::boolalpha << same << ", size: " << list2.size() << ", capacity: " << list2.capacity() << lf;
+	list2.sort();
+	std_list.sort();
+	same = list2.size() == std_list.size();
+	for(auto it = std_list.begin(); int i: list2) same = same and i == *it++;
+	cout << "sort: " << same << ", is_sorted: " << list2.is_sorted() << ", back: " << list2.back() << lf;
+	compact_double_list<int> list3 = {9, 1, 5, 3}, list4 = {0, 2, 4, 8, 30};
+	list3.sort();
+	list3.merge(std::move(list4));
+	cout << "merge: " << list3 << ", back: " << list3.back() << ", size: " << list3.size() << ", list4: " << list4 << lf;
+	compact_double_list<int> list6 = {9, 1, 5, 3, 7}, list7 = {0, 2, 4, 8, 30};
+	int calls = 0;
+	try {
+		list6.merge(std::move(list7), [&](int a, int b) {if(++calls == 3) throw calls; return a < b; });
+	}catch(int) {}
+	long long sum = 0;
+	for(int i: list6) sum += i;
+	cout << "merge with a throwing comparator: size: " << list6.size() << ", sum: " << sum << ", list7: " << list7.size() << lf;
+	compact_double_list<int> list5 = {100, 101};
+	list5.splice(list5.begin(), list3, ++list3.begin(), ++++++++list3.begin());
+	list5.splice(list5.end(), list3, list3.begin());
+	list3.splice(list3.begin(), list3, ++++list3.begin(), list3.end());
+	cout << "splice: " << list5 << ", back: " << list5.back() << lf << list3 << ", back: " << list3.back() << ", size: " << list3.size() << lf;
+	cout << "finished test\n";
+}
+
+void test_compact_speed() {
+	using namespace rais::study;
+	auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+
+	for(int round = 0; round < 2; round++) {
+		auto start = std::chrono::steady_clock::now();
+		long long sum = 0;
+		if(round == 0) {
+			double_list<int> list;
+			for(int i = 0; i < 1000'0000; i++) list.push(i);
+			for(int i: list) sum += i;
+		}else {
+			compact_double_list<int> list;
+			for(int i = 0; i < 1000'0000; i++) list.push(i);
+			for(int i: list) sum += i;
+		}
+		auto end = std::chrono::steady_clock::now();
+		std::cout << (round == 0 ? "double_list" : "compact_double_list") << " push, traverse & destroy 10M: " << seconds(start, end) << "s (" << sum % 10 << ")\n";
+	}
+}
+
+int main() {
+	test_compact_double_list();
+	// test_compact_speed();
+}
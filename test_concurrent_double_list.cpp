@@ -0,0 +1,96 @@
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <concurrent_double_list.hpp>
+
+void test_concurrent_double_list() {
+	using namespace rais::study;
+	using std::cout;
+	constexpr char lf = '\n';
+
+	concurrent_double_list<int> deque;
+	for(int i = 0; i < 5; i++) deque.push_back(i);
+	deque.push_front(-1);
+	cout << "1. test push: " << deque.size() << ", front: " << *deque.try_pop_front() << ", back: " << *deque.try_pop_back() << lf;
+	// the back part is empty now, half of the front part is moved to it
+	cout << "2. test pop across the parts: ";
+	for(int i = 0; i < 4; i++) cout << *deque.try_pop_back() << ' ';
+	cout << std::boolalpha << deque.try_pop_front().has_value() << lf;
+
+	deque.push_back(double_list<int>{1, 2, 3, 4, 5, 6});
+	deque.push_front(double_list<int>{-2, -1, 0});
+	cout << "3. test batch push: " << deque.size() << lf;
+	cout << "4. test batch pop: " << deque.try_pop_front(2) << deque.try_pop_back(4) << deque.try_pop_front(10) << deque.try_pop_back(1) << ", " << deque.size() << lf;
+
+	// 4 producers and 4 consumers at the opposite ends
+	constexpr int producers = 4, per_producer = 10'0000;
+	std::atomic<long long> sum = 0;
+	std::atomic<int> popped = 0;
+	{
+		std::vector<std::jthread> consumers;
+		for(int t = 0; t < 4; t++) consumers.emplace_back([&, t] {
+			while(auto val = (t % 2 == 0 ? deque.pop_front() : deque.pop_back())) {
+				sum += *val;
+				popped++;
+			}
+		});
+		{
+			std::vector<std::jthread> pushers;
+			for(int t = 0; t < producers; t++) pushers.emplace_back([&, t] {
+				for(int i = 1; i <= per_producer; i++) {
+					if(t % 2 == 0) deque.push_back(i);
+					else deque.push_front(i);
+				}
+			});
+		}
+		deque.close();
+	}
+	cout << "5. test blocking pop & close: " << popped << ", " << (sum == producers * (per_producer * (per_producer + 1LL) / 2)) << ", " << deque.size() << lf;
+}
+
+void test_concurrent_double_list_speed() {
+	using namespace rais::study;
+	using std::cout;
+
+	auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+	// a double_list behind a single lock, for comparison
+	struct locked_list {
+		double_list<int> list;
+		std::mutex mutex;
+		void push_back(int val) {std::lock_guard lock{mutex}; list.push(val); }
+		bool try_pop_front() {
+			std::lock_guard lock{mutex};
+			if(list.is_empty()) return false;
+			list.shift();
+			return true;
+		}
+	};
+
+	constexpr int total = 400'0000;
+	auto run = [&](auto& deque, int threads) {
+		// half of the threads push at the back, the others pop at the front
+		int pairs = threads < 2 ? 1 : threads / 2, per_thread = total / pairs;
+		auto start = std::chrono::steady_clock::now();
+		{
+			std::vector<std::jthread> workers;
+			for(int t = 0; t < pairs; t++) {
+				workers.emplace_back([&] {for(int i = 0; i < per_thread; i++) deque.push_back(i); });
+				workers.emplace_back([&] {for(int i = 0; i < per_thread; ) if(deque.try_pop_front()) i++; });
+			}
+		}
+		return seconds(start, std::chrono::steady_clock::now());
+	};
+	for(int threads = 1; threads <= 64; threads *= 2) {
+		concurrent_double_list<int> deque;
+		locked_list locked;
+		cout << threads << " threads: concurrent_double_list: " << run(deque, threads) << "s, single lock: " << run(locked, threads) << "s\n";
+	}
+}
+
+int main() {
+	test_concurrent_double_list();
+	// test_concurrent_double_list_speed();
+}
@@ -1,3 +1,7 @@
+#include <list>
+#include <chrono>
+#include <random>
+#include <vector>
 #include <double_list.hpp>
 #include <iostream>
 
@@ -29,9 +33,175 @@ void test_double_list() {
 	cout << list2 << lf;
 	list2.reverse();
 	cout << list2 << lf;
+	cout << "sort list2: \n";
+	list2.sort();
+	cout << list2 << ", is_sorted: " << std::boolalpha << list2.is_sorted() << ", back: " << list2.back() << lf;
+	cout << "merge list3 into list2: \n";
+	double_list<int> list3{0, 2, 7, 30};
+	list2.merge(std::move(list3));
+	cout << list2 << ", size: " << list2.size() << ", back: " << list2.back() << ", list3: " << list3 << lf;
+	cout << "splice list2[1, 4) to the front of list4: \n";
+	double_list<int> list4{100, 101};
+	list4.splice(list4.begin(), list2, ++list2.begin(), ++++++++list2.begin());
+	list4.splice(list4.end(), list2, list2.begin());
+	cout << list4 << ", back: " << list4.back() << lf << list2 << ", size: " << list2.size() << lf;
+	cout << "assign and append_range: \n";
+	std::vector<int> values{5, 4, 3, 2, 1, 0, 1, 2, 3, 4, 5};
+	double_list<int> list5(values.begin() + 5, values.end());
+	list5.append_range(values);
+	const int* address = &list5.back();
+	list5.assign(values.begin(), values.begin() + 3);
+	list5.push(-1);
+	cout << list5 << ", back: " << list5.back() << ", reused: " << (address == &list5.back()) << lf;
+	list5 = list4;
+	cout << list5 << ", back: " << list5.back() << ", size: " << list5.size() << lf;
+	cout << "relayout: \n";
+	for(int i = 0; i < 6; i++) list5.insert(i * 2, i);
+	cout << "reclaimed " << list5.relayout() << " bytes, " << list5 << ", back: " << list5.back() << ", [7]: " << list5[7] << ", stride: " << list5.average_stride() << lf;
+	cout << "prefetch_policy::ahead and for_each: \n";
+	double_list<int, std::allocator<int>, prefetch_policy::ahead<2>> list6{5, 1, 4, 2, 3};
+	list6.sort();
+	list6.merge(double_list<int, std::allocator<int>, prefetch_policy::ahead<2>>{0, 3, 6});
+	list6.reverse();
+	int sum = 0;
+	list6.for_each<3>([&sum](const int& v) {sum += v; });
+	cout << list6 << ", back: " << list6.back() << ", sum: " << sum << lf;
+	cout << "extract and node_handle: \n";
+	double_list<int> list7{1, 2, 3};
+	{
+		//the extracted nodes are in the block of list8, which is released after list7 holds them
+		double_list<int> list8(values.begin(), values.end());
+		list7.push(list8.extract(3));
+		list7.unshift(list8.extract(list8.begin()));
+		list7.insert(1, list8.extract(double_list<int>::iterator_t{list8.head->priv}));
+		list7.insert(list7.end(), list8.extract(100));
+		auto handle = list8.extract(4);
+		handle.value() = 42;
+		list7.insert(++list7.begin(), std::move(handle));
+	}
+	cout << list7 << ", back: " << list7.back() << ", size: " << list7.size() << ", [2]: " << list7[2] << lf;
 	cout << "finished test\n";
 }
 
+void test_cursor() {
+	using namespace rais::study;
+	using std::cout;
+	constexpr char lf = '\n';
+
+	//compare with std::list under random positional operations
+	std::minstd_rand randint{42};
+	double_list<int> list;
+	std::list<int> std_list;
+	bool same = true;
+	for(int i = 0; i < 20000; i++) {
+		size_t op = randint() % 9,
+		       index = std_list.size() == 0 ? 0 : randint() % std_list.size();
+		if(op < 3 or std_list.size() == 0) {
+			list.insert(index, i);
+			std_list.insert(std::next(std_list.begin(), index), i);
+		}else if(op == 3) {
+			list.erase(index);
+			std_list.erase(std::next(std_list.begin(), index));
+		}else if(op == 4) {
+			list.unshift(i);
+			std_list.push_front(i);
+		}else if(op == 5) {
+			list.shift();
+			std_list.pop_front();
+		}else if(op == 6) {
+			list.pop();
+			std_list.pop_back();
+		}else {
+			same = same and list[index] == *std::next(std_list.begin(), index);
+		}
+	}
+	cout << "cursor: random operations: " << std::boolalpha << same << ", size: " << list.size() << lf;
+
+	list.clear();
+	for(int i = 0; i < 100'0000; i++) list.push(i);
+	auto start = std::chrono::steady_clock::now();
+	long long sum = 0;
+	for(size_t i = 0; i < list.size(); i++) sum += list[i];
+	auto end = std::chrono::steady_clock::now();
+	cout << "cursor: sequential operator[] on " << list.size() << " nodes: " << std::chrono::duration<double>(end - start).count() << "s (" << sum % 10 << ")" << lf;
+}
+
+void test_bulk_assign() {
+	using namespace rais::study;
+	using std::cout;
+
+	//refresh a list from a snapshot repeatedly, the sizes of the snapshots vary
+	auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+	std::minstd_rand randint{42};
+	std::vector<double_list<int>> snapshots;
+	for(int i = 0; i < 8; i++) {
+		std::vector<int> values(90'0000 + randint() % 20'0000);
+		for(auto& v: values) v = randint();
+		snapshots.emplace_back(values.begin(), values.end());
+	}
+
+	double_list<int> list;
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < 100; i++) {
+		list.clear();
+		for(int v: snapshots[i % 8]) list.push(v);
+	}
+	auto end = std::chrono::steady_clock::now();
+	cout << "clear and push: " << seconds(start, end) << "s\n";
+
+	start = std::chrono::steady_clock::now();
+	for(int i = 0; i < 100; i++) list = snapshots[i % 8];
+	end = std::chrono::steady_clock::now();
+	cout << "copy assignment: " << seconds(start, end) << "s, " << std::boolalpha << (list.size() == snapshots[99 % 8].size()) << '\n';
+
+	start = std::chrono::steady_clock::now();
+	for(int i = 0; i < 100; i++) double_list<int> copy{snapshots[i % 8]};
+	end = std::chrono::steady_clock::now();
+	cout << "copy construction: " << seconds(start, end) << "s\n";
+}
+
+void test_relayout() {
+	using namespace rais::study;
+	using std::cout;
+
+	//scatter the nodes by random insertions and erasures, then compare the traversal before and after relayout()
+	auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+	std::minstd_rand randint{42};
+	std::vector<int> values(100'0000);
+	for(auto& v: values) v = randint();
+	double_list<int> list(values.begin(), values.end());
+	for(int pass = 0; pass < 8; pass++) {
+		for(auto it = list.begin(); it != list.end(); ) {
+			int r = randint() % 4;
+			if(r == 0) list.erase(it++);
+			else if(r == 1) list.insert(it++, pass);
+			else ++it;
+		}
+	}
+	auto traverse = [&list, &seconds] {
+		long long sum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for(int k = 0; k < 10; k++) for(int v: list) sum += v;
+		auto end = std::chrono::steady_clock::now();
+		cout << seconds(start, end) << "s (" << sum << "), stride: " << list.average_stride() << " bytes\n";
+	};
+	cout << "traverse " << list.size() << " nodes after churn: ";
+	traverse();
+	auto start = std::chrono::steady_clock::now();
+	auto reclaimed = list.relayout();
+	auto end = std::chrono::steady_clock::now();
+	cout << "relayout: " << seconds(start, end) << "s, reclaimed " << reclaimed << " bytes\n";
+	cout << "traverse after relayout: ";
+	traverse();
+	start = std::chrono::steady_clock::now();
+	list.clear();
+	end = std::chrono::steady_clock::now();
+	cout << "clear: " << seconds(start, end) << "s\n";
+}
+
 int main() {
 	test_double_list();
+	test_cursor();
+	// test_bulk_assign();
+	// test_relayout();
 }
\ No newline at end of file
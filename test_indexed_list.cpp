@@ -0,0 +1,126 @@
+#include <random>
+#include <chrono>
+#include <string>
+#include <iostream>
+#include <linked_list.hpp>
+#include <indexed_list.hpp>
+
+void test_indexed_list_basic() {
+	using namespace rais::study;
+
+	indexed_list<std::string> list;
+	// test push
+	list.push("1. Test push");
+	// test unshift
+	list.unshift("2. Test unshift");
+	// test insert
+	list.insert(0, "3. Test insert");
+	// test operator[]
+	std::cout << "4. Test operator[]{" << list[2] << "}\n";
+	// test get_ptr
+	std::cout << "5. Test get_ptr{" << *list.get_ptr(0) << "}\n";
+	std::cout << list << '\n';
+	// test erase
+	std::cout << "6. Test erase\n";
+	list.erase(1);
+	std::cout << list << '\n';
+	// test clear
+	std::cout << "7. Test clear\n";
+	list.clear();
+	std::cout << list << '\n';
+	// test reverse
+	std::cout << "8. Test reverse from:";
+	list.push("1").push("2").push("3").push("4").push("5").push("6").unshift("0").unshift("-1");
+	std::cout << list << "\n";
+	list.reverse();
+	std::cout << "to: " << list << ", [2]: " << list[2] << '\n';
+	// test shift
+	std::cout << "9. Test shift: " << list.shift() << '\n';
+	//test pop
+	std::cout << "10. Test pop: "  << list.pop() << '\n';
+	std::cout << "current list: " << list << ", back: " << list.back() << '\n';
+	// test copy and swap
+	auto list2 = list;
+	list2.push("this is from list2");
+	swap(list, list2);
+	std::cout << "11. test copy & swap: " << list << ", " << list2[list2.size() - 1] << '\n';
+	// test sort and lower_bound
+	auto list3 = indexed_list<int>{52, 99, 7, 3, 5, 7, 2, 2, 34, 53, 53, 12, 42, 94, 53, 81, 1, 4, 9};
+	list3.sort();
+	std::cout << "12. test sort: " << list3 << ", [9]: " << list3[9] << '\n';
+	std::cout << "13. test lower_bound: " << *list3.lower_bound(53) << ", " << *list3.lower_bound(10) << ", " << std::boolalpha << (list3.lower_bound(100) == list3.end()) << '\n';
+
+	// compare with linked_list under random positional operations
+	std::minstd_rand randint{42};
+	indexed_list<int> list4;
+	linked_list<int> list5;
+	bool same = true;
+	for(int i = 0; i < 20000; i++) {
+		size_t op = randint() % 4,
+		       index = list5.size() == 0 ? 0 : randint() % list5.size();
+		if(op < 2 or list5.size() == 0) {
+			list4.insert(index, i);
+			list5.insert(index, i);
+		}else if(op == 2) {
+			list4.erase(index);
+			list5.erase(index);
+		}else if(list4[index] != list5[index]) {
+			same = false;
+		}
+		if(i % 5000 == 0) {
+			list4.quick_sort();
+			list5.quick_sort();
+		}
+	}
+	for(size_t i = 0; i < list5.size(); i++) same = same and list4[i] == list5[i];
+	std::cout << "14. test random insert & erase: " << same << ", size: " << list4.size() << ", back: " << (list4.back() == list5.back()) << '\n';
+	// the lanes are moved with the nodes, then the const accesses are O(log n)
+	indexed_list<int> list6;
+	list6 = std::move(list4);
+	const indexed_list<int>& list7 = list6;
+	same = list4.is_empty();
+	for(size_t i = 0; i < list5.size(); i++) same = same and list7[i] == list5[i];
+	list6.sort();
+	list6.build_index();
+	std::cout << "15. test move assignment & const access: " << same << ", size: " << list7.size() << ", [0]: " << list7[0] << '\n';
+}
+
+void test_indexed_access() {
+	using namespace rais::study;
+
+	indexed_list<int> ilist;
+	linked_list<int> list;
+	for(int i = 0; i < 10'0000; i++) {
+		ilist.push(i);
+		list.push(i);
+	}
+	std::cout << "length: " << ilist.size() << '\n';
+	auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+
+	auto start = std::chrono::steady_clock::now();
+	long long sum = 0;
+	for(size_t i = 0; i < list.size(); i++) sum += list[i];
+	auto end = std::chrono::steady_clock::now();
+	std::cout << "linked_list  operator[]: " << seconds(start, end) << "s (" << sum % 10 << ")\n";
+
+	start = std::chrono::steady_clock::now();
+	sum = 0;
+	for(size_t i = 0; i < ilist.size(); i++) sum += ilist[i];
+	end = std::chrono::steady_clock::now();
+	std::cout << "indexed_list operator[]: " << seconds(start, end) << "s (" << sum % 10 << ")\n";
+
+	start = std::chrono::steady_clock::now();
+	for(size_t i = 0; i < 10000; i++) list.insert(list.size() / 2, 0);
+	end = std::chrono::steady_clock::now();
+	std::cout << "linked_list  insert(middle): " << seconds(start, end) << "s\n";
+
+	start = std::chrono::steady_clock::now();
+	for(size_t i = 0; i < 10000; i++) ilist.insert(ilist.size() / 2, 0);
+	end = std::chrono::steady_clock::now();
+	std::cout << "indexed_list insert(middle): " << seconds(start, end) << "s\n";
+}
+
+int main() {
+	test_indexed_list_basic();
+	// test_indexed_access();
+}
@@ -0,0 +1,55 @@
+#include <string>
+#include <vector>
+#include <iostream>
+#include <intrusive_double_list.hpp>
+
+struct session {
+	int id;
+	std::string user;
+	rais::study::double_hook by_time{}, //links of the list ordered by the last activity
+	                         by_user{}; //links of the list of the same user
+};
+
+std::ostream& operator<<(std::ostream& os, const session& s) {
+	return os << s.id << ':' << s.user;
+}
+
+void test_intrusive_double_list() {
+	using namespace rais::study;
+	using std::cout;
+	constexpr char lf = '\n';
+
+	std::vector<session> sessions;
+	for(int i = 0; i < 6; i++) sessions.push_back(session{i, i % 2 == 0 ? "alice" : "bob"});
+
+	intrusive_double_list<session, &session::by_time> by_time;
+	intrusive_double_list<session, &session::by_user> alice;
+	for(auto& s: sessions) {
+		by_time.push(s);
+		if(s.user == "alice") alice.unshift(s);
+	}
+	cout << "1. test push & unshift: " << by_time << ", " << alice << ", back: " << by_time.back() << lf;
+	// move the session 2 to the most recent end in O(1)
+	by_time.erase(sessions[2]);
+	by_time.push(sessions[2]);
+	cout << "2. test erase(obj) & push: " << by_time << ", linked: " << std::boolalpha << sessions[2].by_time.is_linked() << lf;
+	alice.erase(sessions[0]);
+	cout << "3. test membership of several lists: " << alice << ", " << by_time.size() << ", " << sessions[0].by_user.is_linked() << lf;
+	by_time.insert(by_time.iterator_to(sessions[3]), by_time.shift());
+	cout << "4. test shift & insert: " << by_time << ", [2]: " << by_time[2] << ", [4]: " << by_time[4] << lf;
+	by_time.reverse();
+	cout << "5. test reverse: " << by_time << ", back: " << by_time.back() << ", pop: " << by_time.pop() << lf;
+	cout << "6. test iterate backward: ";
+	for(auto it = by_time.iterator_to(by_time.back()); ; --it) {
+		cout << *it << ' ';
+		if(it == by_time.begin()) break;
+	}
+	cout << lf;
+	auto moved = std::move(by_time);
+	moved.clear();
+	cout << "7. test move & clear: " << moved << by_time << ", linked: " << sessions[1].by_time.is_linked() << ", " << sessions[4].by_user.is_linked() << lf;
+}
+
+int main() {
+	test_intrusive_double_list();
+}
@@ -1,6 +1,9 @@
 
 #include <random>
 #include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
 #include <iostream>
 #include <linked_list.hpp>
 
@@ -63,6 +66,84 @@ void test_linked_list_basic() {
 	std::cout << "16. test quick_sort: \nbefore quick_sort: " << list6 << '\n';
 	list6.quick_sort();
 	std::cout << "after quick_sort: " << list6 << '\n';
+	std::cout << "17. test back after sort: " << list6.back() << '\n';
+	// test before_begin
+	linked_list<int> list7;
+	list7.insert_after(list7.before_begin(), 2).insert_after(list7.before_begin(), 1).push(3);
+	std::cout << "18. test insert_after(before_begin()): " << list7 << ", back: " << list7.back() << '\n';
+	list7.erase_after(list7.before_begin());
+	list7.erase_after(list7.begin());
+	list7.push(4);
+	std::cout << "19. test erase_after(before_begin()): " << list7 << ", back: " << list7.back() << '\n';
+	list7.reverse();
+	list7.pop();
+	list7.push(5);
+	std::cout << "20. test push after reverse and pop: " << list7 << ", back: " << list7.back() << '\n';
+	auto list8 = linked_list<int>{52, 99, 7, 3, 5, 7, 2, 2, 34, 53, 53, 12, 42, 94, 53, 81, 1, 4, 9};
+	list8.parallel_sort(less<int>{}, 4);
+	std::cout << "21. test parallel_sort: " << list8 << ", back: " << list8.back() << '\n';
+	linked_list<int> list9;
+	for(int i = 0; i < 100000; i++) list9.push(i % 3 == 0 ? 7 : i);
+	list9.quick_sort();
+	std::cout << "22. test quick_sort on nearly sorted input: " << list9.is_sorted() << ", back: " << list9.back() << '\n';
+	list9.reverse();
+	list9.merge_sort();
+	std::cout << "23. test merge_sort on reversed input: " << list9.is_sorted() << ", back: " << list9.back() << '\n';
+	auto list10 = linked_list<int>{1, 3, 5, 7, 9, 8, 6, 4, 2, 0, 10, 11, 12, 2, 2, 2, 13, 12};
+	list10.sort(sort_policy::natural);
+	std::cout << "24. test sort(sort_policy::natural): " << list10 << ", back: " << list10.back() << '\n';
+	auto list11 = linked_list<int>{52, -99, 7, 3, -5, 7, 2, 2, 34, -53, 53, 12, 42, 1 << 30, 53, -81, 1, 4, -(1 << 30)};
+	list11.radix_sort();
+	std::cout << "25. test radix_sort with signed keys: " << list11 << ", back: " << list11.back() << '\n';
+	auto list12 = linked_list<std::pair<long, char>>{{300, 'a'}, {-2, 'b'}, {300, 'c'}, {7, 'd'}, {-2, 'e'}, {7, 'f'}};
+	list12.radix_sort(&std::pair<long, char>::first);
+	std::cout << "26. test radix_sort(proj) is stable: ";
+	for(const auto& [key, c]: list12) std::cout << c;
+	std::cout << '\n';
+	auto list13 = linked_list<std::string>{"52", "99", "7", "3", "5", "7", "2", "2", "34", "53", "53", "12", "42", "94", "53", "81", "1", "4", "9"};
+	const std::string* address = &*++list13.begin(); //"99"
+	list13.sort(sort_policy::gather);
+	std::cout << "27. test sort(sort_policy::gather): " << list13 << ", back: " << list13.back() << ", not moved: " << std::boolalpha << (address == &list13.back()) << '\n';
+	list13.reverse();
+	list13.gather_sort(std::less<std::string>{}, 4);
+	std::cout << "28. test gather_sort with 4 threads: " << list13 << ", back: " << list13.back() << '\n';
+	std::vector<int> values{5, 4, 3, 2, 1, 0, 1, 2, 3, 4, 5};
+	linked_list<int> list14(values.begin() + 5, values.end());
+	list14.append_range(values);
+	std::cout << "29. test range constructor & append_range: " << list14 << ", back: " << list14.back() << ", size: " << list14.size() << '\n';
+	const int* first_address = &list14.front();
+	list14.assign(values.begin(), values.begin() + 3);
+	list14.push(-1);
+	std::cout << "30. test assign: " << list14 << ", back: " << list14.back() << ", reused: " << (first_address == &list14.front()) << '\n';
+	list14 = list10;
+	std::cout << "31. test copy assignment: " << list14 << ", back: " << list14.back() << ", reused: " << (first_address == &list14.front()) << '\n';
+	for(int i = 0; i < 6; i++) list14.insert(i * 3, i);
+	std::cout << "32. test relayout: reclaimed " << list14.relayout() << " bytes, " << list14 << ", back: " << list14.back() << ", stride: " << list14.average_stride() << '\n';
+	linked_list<int, std::allocator<int>, prefetch_policy::ahead<4>> list15{9, 3, 7, 1, 8, 2, 6, 4, 5, 0, 3};
+	list15.sort();
+	int sum = 0;
+	list15.for_each<4>([&sum](int& v) {sum += v; v *= 2; });
+	std::cout << "33. test prefetch_policy::ahead & for_each: " << list15 << ", sum: " << sum << ", sorted: " << list15.is_sorted() << '\n';
+	linked_list<int> list16{1, 2, 3};
+	const int* node_address;
+	{
+		//the extracted nodes are in the block of list17, which is released after list16 holds them
+		linked_list<int> list17(values.begin(), values.end());
+		auto handle = list17.extract(3);
+		node_address = &handle.value();
+		list16.push(std::move(handle));
+		list16.unshift(list17.extract_after(list17.before_begin()));
+		list16.insert_after(list16.begin(), list17.extract(100));
+		list16.insert(2, list17.extract_after(++list17.begin()));
+	}
+	std::cout << "34. test extract & node_handle: " << list16 << ", back: " << list16.back() << ", size: " << list16.size() << ", not moved: " << (node_address == &list16.back()) << '\n';
+	linked_list<int> list18{10, 11, 12, 13, 14};
+	list16.splice_after(list16.before_begin(), list18, list18.begin(), ++++++list18.begin());
+	list16.splice_after(list16.begin(), list18, list18.before_begin());
+	std::cout << "35. test splice_after: " << list16 << ", back: " << list16.back() << ", size: " << list16.size() << ", " << list18 << ", back: " << list18.back() << ", size: " << list18.size() << '\n';
+	list16.splice_after(++list16.begin(), list18);
+	list16.splice_after(list16.before_begin(), list16, ++list16.begin(), list16.end());
+	std::cout << "36. test splice_after a whole list & itself: " << list16 << ", back: " << list16.back() << ", size: " << list16.size() << ", " << list18.is_empty() << '\n';
 }
 
 void test_sort() {
@@ -73,7 +154,7 @@ void test_sort() {
 
 	linked_list<int> list;
 	for(int i = 0; i < 1000'0000; i++) {
-		list.unshift(mask(randint));
+		list.push(mask(randint));
 	}
 	std::cout << "length: " << list.size() << '\n';
 	auto start = std::chrono::steady_clock::now();
@@ -85,11 +166,135 @@ void test_sort() {
 
 }
 
-int main() {
-	// std::ios::sync_with_stdio();
+void test_prefetch() {
+	using namespace rais::study;
+
+	//the list of test_sort(), the nodes are scattered after sorting, then the traversals are measured
+	auto run = [](auto list, const char* name) {
+		std::minstd_rand randint{42};
+		for(int i = 0; i < 1000'0000; i++) list.push(static_cast<int>(randint()));
+		auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+		auto start = std::chrono::steady_clock::now();
+		list.sort();
+		auto end = std::chrono::steady_clock::now();
+		std::cout << name << ": sort " << seconds(start, end) << "s";
+
+		start = std::chrono::steady_clock::now();
+		bool sorted = list.is_sorted();
+		end = std::chrono::steady_clock::now();
+		std::cout << ", is_sorted " << seconds(start, end) << "s (" << std::boolalpha << sorted << ")";
+
+		long long sum = 0;
+		start = std::chrono::steady_clock::now();
+		list.for_each([&sum](const int& v) {sum += v; });
+		end = std::chrono::steady_clock::now();
+		std::cout << ", for_each " << seconds(start, end) << "s (" << sum << ")";
+
+		start = std::chrono::steady_clock::now();
+		list.reverse();
+		end = std::chrono::steady_clock::now();
+		std::cout << ", reverse " << seconds(start, end) << "s";
+
+		start = std::chrono::steady_clock::now();
+		list.clear();
+		end = std::chrono::steady_clock::now();
+		std::cout << ", clear " << seconds(start, end) << "s\n";
+	};
+	run(linked_list<int>{}, "no prefetch");
+	run(linked_list<int, std::allocator<int>, prefetch_policy::ahead<4>>{}, "ahead<4>");
+	run(linked_list<int, std::allocator<int>, prefetch_policy::ahead<16>>{}, "ahead<16>");
+}
+
+void test_radix_sort() {
+	using namespace rais::study;
+
+	std::minstd_rand randint{std::random_device{}()};
+	std::uniform_int_distribution mask;
+
+	linked_list<int> source;
+	for(int i = 0; i < 1000'0000; i++) {
+		source.push(mask(randint));
+	}
+	std::cout << "length: " << source.size() << '\n';
+	{
+		auto list = source;
+		auto start = std::chrono::steady_clock::now();
+		list.quick_sort();
+		auto end = std::chrono::steady_clock::now();
+		std::cout << "quick_sort: " << std::chrono::duration<double>(end-start).count() << "s, " << std::boolalpha << list.is_sorted() << '\n';
+	}
+	{
+		auto list = source;
+		auto start = std::chrono::steady_clock::now();
+		list.radix_sort();
+		auto end = std::chrono::steady_clock::now();
+		std::cout << "radix_sort: " << std::chrono::duration<double>(end-start).count() << "s, " << std::boolalpha << list.is_sorted() << '\n';
+	}
+}
+
+void test_gather_sort() {
+	using namespace rais::study;
+
+	std::minstd_rand randint{std::random_device{}()};
+	std::uniform_int_distribution mask;
+	auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+
+	for(size_t n = 1000; n <= 1000'0000; n *= 10) {
+		linked_list<int> source;
+		for(size_t i = 0; i < n; i++) {
+			source.push(mask(randint));
+		}
+		std::cout << "length: " << source.size() << '\n';
+
+		auto list = source;
+		auto start = std::chrono::steady_clock::now();
+		list.quick_sort();
+		auto end = std::chrono::steady_clock::now();
+		std::cout << "  quick_sort:  " << seconds(start, end) << "s, " << std::boolalpha << list.is_sorted() << '\n';
+
+		list = source;
+		start = std::chrono::steady_clock::now();
+		list.merge_sort();
+		end = std::chrono::steady_clock::now();
+		std::cout << "  merge_sort:  " << seconds(start, end) << "s, " << std::boolalpha << list.is_sorted() << '\n';
+
+		list = source;
+		start = std::chrono::steady_clock::now();
+		list.gather_sort();
+		end = std::chrono::steady_clock::now();
+		std::cout << "  gather_sort: " << seconds(start, end) << "s, " << std::boolalpha << list.is_sorted() << '\n';
+	}
+}
+
+void test_parallel_sort() {
+	using namespace rais::study;
 
+	std::minstd_rand randint{std::random_device{}()};
+	std::uniform_int_distribution mask;
 
+	linked_list<int> source;
+	for(int i = 0; i < 1000'0000; i++) {
+		source.push(mask(randint));
+	}
+	std::cout << "length: " << source.size() << '\n';
+	size_t max_threads = std::thread::hardware_concurrency();
+	for(size_t threads = 1; ; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+		auto list = source;
+		auto start = std::chrono::steady_clock::now();
+		list.parallel_sort(std::less<int>{}, threads);
+		auto end = std::chrono::steady_clock::now();
+		std::cout << threads << " thread(s): " << std::chrono::duration<double>(end-start).count() << "s, " << std::boolalpha << list.is_sorted() << '\n';
+		if(threads >= max_threads) break;
+	}
+}
 
-	// test_linked_list();
+int main() {
+	// std::ios::sync_with_stdio();
+
+	test_linked_list_basic();
 	test_sort();
-}
\ No newline at end of file
+	test_prefetch();
+	test_radix_sort();
+	test_gather_sort();
+	test_parallel_sort();
+}
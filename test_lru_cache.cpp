@@ -0,0 +1,89 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <iostream>
+#include <lru_cache.hpp>
+
+void test_lru_cache_basic() {
+	using namespace rais::study;
+	using std::cout;
+	constexpr char lf = '\n';
+
+	lru_cache<int, std::string> lru{3};
+	lru.put(1, "one");
+	lru.put(2, "two");
+	lru.put(3, "three");
+	cout << "1. test get: " << *lru.get(1) << ", " << (lru.get(4) == nullptr) << lf;
+	// 2 is the least recently used
+	lru.put(4, "four");
+	cout << "2. test eviction (lru): " << std::boolalpha << lru.contains(1) << lru.contains(2) << lru.contains(3) << lru.contains(4) << lf;
+	lru.put(3, "THREE");
+	lru.put(5, "five");
+	cout << "3. test assign & eviction: " << *lru.peek(3) << ", " << lru.contains(1) << lru.contains(4) << ", size: " << lru.size() << lf;
+	lru.erase(3);
+	lru.put(6, "six");
+	cout << "4. test erase: " << lru.contains(3) << lru.contains(4) << lru.contains(5) << lru.contains(6) << ", size: " << lru.size() << lf;
+	cout << "5. test stats: hits " << lru.stats().hits << ", misses " << lru.stats().misses << ", evictions " << lru.stats().evictions << lf;
+	lru.clear();
+	lru.put(7, "seven");
+	cout << "6. test clear: " << lru.contains(5) << lru.contains(7) << ", size: " << lru.size() << lf;
+
+	lru_cache<int, int, cache_policy::lfu_t> lfu{3};
+	lfu.put(1, 10);
+	lfu.put(2, 20);
+	lfu.put(3, 30);
+	lfu.get(1);
+	lfu.get(1);
+	lfu.get(2);
+	lfu.get(3);
+	// 3 and 2 are used twice, 2 is the least recently used of them
+	lfu.put(4, 40);
+	cout << "7. test eviction (lfu): " << lfu.contains(1) << lfu.contains(2) << lfu.contains(3) << lfu.contains(4) << lf;
+	// 4 is used once
+	lfu.put(5, 50);
+	cout << "8. test eviction of a new entry: " << lfu.contains(3) << lfu.contains(4) << lfu.contains(5) << lf;
+	lfu.erase(1);
+	lfu.put(6, 60);
+	lfu.put(7, 70);
+	cout << "9. test erase (lfu): " << lfu.contains(1) << lfu.contains(3) << lfu.contains(5) << lfu.contains(6) << lfu.contains(7) << ", evictions: " << lfu.stats().evictions << lf;
+
+	// std::hash<int> is the identity, the keys with a stride of 4096 would share a few home slots without mixing
+	lru_cache<int, int> strided{5'0000};
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < 5'0000; i++) strided.put(i << 12, i);
+	for(int i = 0; i < 5'0000; i += 2) strided.erase(i << 12);
+	bool found = true;
+	for(int i = 0; i < 5'0000; i++) found = found and strided.contains(i << 12) == (i % 2 == 1);
+	auto end = std::chrono::steady_clock::now();
+	cout << "10. test strided keys: " << found << ", size: " << strided.size() << ", " << std::chrono::duration<double>(end - start).count() << "s" << lf;
+}
+
+void test_lru_cache_speed() {
+	using namespace rais::study;
+
+	std::minstd_rand randint{std::random_device{}()};
+	lru_cache<int, int> lru{10'0000};
+	lru_cache<int, int, cache_policy::lfu_t> lfu{10'0000};
+	auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < 1000'0000; i++) {
+		int key = randint() % 20'0000;
+		if(lru.get(key) == nullptr) lru.put(key, i);
+	}
+	auto end = std::chrono::steady_clock::now();
+	std::cout << "lru: " << seconds(start, end) << "s, hits: " << lru.stats().hits << ", evictions: " << lru.stats().evictions << '\n';
+
+	start = std::chrono::steady_clock::now();
+	for(int i = 0; i < 1000'0000; i++) {
+		int key = randint() % 20'0000;
+		if(lfu.get(key) == nullptr) lfu.put(key, i);
+	}
+	end = std::chrono::steady_clock::now();
+	std::cout << "lfu: " << seconds(start, end) << "s, hits: " << lfu.stats().hits << ", evictions: " << lfu.stats().evictions << '\n';
+}
+
+int main() {
+	test_lru_cache_basic();
+	// test_lru_cache_speed();
+}
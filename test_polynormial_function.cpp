@@ -0,0 +1,37 @@
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+#include <polynormial_function.hpp>
+
+void test_huge_exponent() {
+	using namespace rais::study;
+	using std::cout;
+	constexpr char lf = '\n';
+	constexpr size_t max_n = std::numeric_limits<size_t>::max();
+
+	//the exponents near SIZE_MAX stay in the sparse storage, (degree + 1) * sizeof(double) would overflow
+	polyfunc func1 = {{1, max_n}}, func2 = {{1, 1ull << 62}, {2, 3}};
+	cout << "1. huge exponents: " << func1 << ", dense: " << std::boolalpha << func1.is_dense() << ", degree: " << func1.degree() << ", " << func2 << ", dense: " << func2.is_dense() << lf;
+	const polyfunc& func3 = func2;
+	cout << "2. test const data(): " << func3.data() << ", size: " << func3.data().size() << lf;
+	cout << "3. test multiply: " << (func2 * polyfunc{{1, 1}, {1, 2}}) << ", eval(1): " << func1.eval(1) << lf;
+	try {
+		polyfunc::multiply(func2, polyfunc{{1, 0}, {2, 1}}, multiply_policy::fft);
+		cout << "4. test dense policies: no exception" << lf;
+	}catch(const std::length_error&) {
+		cout << "4. test dense policies: length_error" << lf;
+	}
+	polyfunc sum = func1 + func2;
+	sum -= func1;
+	cout << "5. test += & -=: " << sum << ", size: " << sum.size() << ", dense: " << sum.is_dense() << lf;
+	polyfunc func4 = {{1, 0}, {2, 1}, {3, 2}};
+	func4.add_term(4, max_n).add_term(5, 3);
+	cout << "6. test add_term: " << func4 << ", dense: " << func4.is_dense() << lf;
+	func4.add_term(-4, max_n);
+	cout << "7. test add_term cancelled: " << func4 << ", dense: " << func4.is_dense() << lf;
+}
+
+int main() {
+	test_polynormial_function();
+	test_huge_exponent();
+}
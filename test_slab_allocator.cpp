@@ -0,0 +1,80 @@
+#include <random>
+#include <chrono>
+#include <vector>
+#include <iostream>
+#include <linked_list.hpp>
+#include <double_list.hpp>
+#include <slab_allocator.hpp>
+
+void test_slab_allocator_basic() {
+	using namespace rais::study;
+
+	linked_list<int, slab_allocator<int>> list = {5, 3, 9, 1};
+	list.push(7).unshift(0);
+	std::cout << "1. test linked_list with slab_allocator: " << list << '\n';
+	list.erase(2);
+	list.shift();
+	list.push(11).push(12);
+	std::cout << "2. test recycling: " << list << ", blocks: " << list.get_allocator().get_pool().block_count() << '\n';
+	auto list2 = list;
+	list2.sort();
+	std::cout << "3. test copy (own pool): " << list2 << ", same pool: " << std::boolalpha << (list.get_allocator() == list2.get_allocator()) << '\n';
+	linked_list<int, slab_allocator<int>> list3{list.get_allocator()};
+	list3.push(2).push(8).push(10);
+	list.sort();
+	list.merge(std::move(list3));
+	std::cout << "4. test merge (shared pool): " << list << ", blocks: " << list.get_allocator().get_pool().block_count() << '\n';
+
+	double_list<int, slab_allocator<int>> dlist = {5, 3, 9, 1};
+	dlist.push(7).unshift(0);
+	dlist.erase(3);
+	std::cout << "5. test double_list with slab_allocator: " << dlist << '\n';
+	auto dlist2 = dlist;
+	dlist2.reverse();
+	dlist = dlist2;
+	std::cout << "6. test copy assignment: " << dlist << '\n';
+
+	// the bulk construction allocates a block by ::operator new, the nodes pushed later still come from the slab
+	std::vector<int> values(100, 1);
+	linked_list<int, slab_allocator<int>> list4(values.begin(), values.end());
+	const slab_pool& pool = list4.get_allocator().get_pool();
+	size_t slots = pool.slot_count();
+	for(int i = 0; i < 1000; i++) list4.push(i);
+	std::cout << "7. test slots after bulk construction: " << slots << ", " << pool.slot_count() << ", blocks: " << pool.block_count() << '\n';
+}
+
+template <typename ListT>
+void bench_list(const char* name, size_t count) {
+	std::minstd_rand randint{1};
+	std::uniform_int_distribution mask;
+	auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+
+	auto start = std::chrono::steady_clock::now();
+	ListT list;
+	for(size_t i = 0; i < count; i++) list.unshift(mask(randint));
+	auto built = std::chrono::steady_clock::now();
+	long long sum = 0;
+	for(const auto& i: list) sum += i;
+	auto traversed = std::chrono::steady_clock::now();
+	list.clear();
+	auto cleared = std::chrono::steady_clock::now();
+
+	std::cout << name << ": build " << seconds(start, built) << "s, traverse " << seconds(built, traversed)
+	          << "s, clear " << seconds(traversed, cleared) << "s (" << sum % 10 << ")\n";
+}
+
+void bench_slab_allocator() {
+	using namespace rais::study;
+	constexpr size_t count = 1000'0000;
+
+	std::cout << "length: " << count << '\n';
+	bench_list<linked_list<int>>("linked_list<int>", count);
+	bench_list<linked_list<int, slab_allocator<int>>>("linked_list<int, slab_allocator<int>>", count);
+	bench_list<double_list<int>>("double_list<int>", count);
+	bench_list<double_list<int, slab_allocator<int>>>("double_list<int, slab_allocator<int>>", count);
+}
+
+int main() {
+	test_slab_allocator_basic();
+	// bench_slab_allocator();
+}
@@ -0,0 +1,114 @@
+#include <random>
+#include <chrono>
+#include <string>
+#include <iostream>
+#include <linked_list.hpp>
+#include <unrolled_list.hpp>
+
+void test_unrolled_list_basic() {
+	using namespace rais::study;
+
+	unrolled_list<std::string, 4> list;
+	// test push
+	list.push("1. Test push");
+	// test unshift
+	list.unshift("2. Test unshift");
+	// test insert
+	list.insert(0, "3. Test insert");
+	// test operator[]
+	std::cout << "4. Test operator[]{" << list[2] << "}\n";
+	// test get_ptr
+	std::cout << "5. Test get_ptr{" << *list.get_ptr(0) << "}\n";
+	std::cout << list << '\n';
+	// test erase
+	std::cout << "6. Test erase\n";
+	list.erase(1);
+	std::cout << list << '\n';
+	// test clear
+	std::cout << "7. Test clear\n";
+	list.clear();
+	std::cout << list << '\n';
+	// test reverse
+	std::cout << "8. Test reverse from:";
+	list.push("1").push("2").push("3").push("4").push("5").push("6").unshift("0").unshift("-1");
+	std::cout << list << ", nodes: " << list.node_count() << "\n";
+	list.reverse();
+	std::cout << "to: " << list << '\n';
+	// test shift
+	std::cout << "9. Test shift: " << list.shift() << '\n';
+	//test pop
+	std::cout << "10. Test pop: "  << list.pop() << '\n';
+	std::cout << "current list: " << list << ", back: " << list.back() << '\n';
+	// test split and merge of nodes
+	unrolled_list<int, 4> list2 = {0, 1, 2, 3, 4, 5, 6, 7};
+	list2.insert(2, 100).insert(2, 101).insert(7, 102);
+	std::cout << "11. test insert (split): " << list2 << ", nodes: " << list2.node_count() << '\n';
+	list2.erase(0);
+	list2.erase(0);
+	list2.erase(0);
+	list2.erase(0);
+	std::cout << "12. test erase (merge): " << list2 << ", nodes: " << list2.node_count() << '\n';
+	// test copy and swap
+	auto list3 = list2;
+	list3.push(8);
+	swap(list2, list3);
+	std::cout << "13. test copy & swap: " << list2 << ", " << list3 << '\n';
+	auto list4 = unrolled_list<int, 4>{52, 99, 7, 3, 5, 7, 2, 2, 34, 53, 53, 12, 42, 94, 53, 81, 1, 4, 9};
+	std::cout << "14. test sort: \nbefore sort: " << list4 << '\n';
+	list4.sort();
+	std::cout << " after sort: " << list4 << ", nodes: " << list4.node_count() << ", back: " << list4.back() << '\n';
+	std::cout << "15. test is_sorted: " << std::boolalpha << list4.is_sorted() << '\n';
+	// a throwing comparator leaves the list valid, the values sorted inside a node are unspecified like std::sort
+	auto list5 = unrolled_list<int, 4>{52, 99, 7, 3, 5, 7, 2, 2, 34, 53, 53, 12, 42, 94, 53, 81, 1, 4, 9};
+	int calls = 0;
+	try {
+		list5.sort([&](int a, int b) {if(++calls == 30) throw calls; return a < b; });
+	}catch(int) {}
+	size_t count = 0;
+	for([[maybe_unused]] int i: list5) count++;
+	std::cout << "16. test sort with a throwing comparator: size: " << list5.size() << ", count: " << count << '\n';
+}
+
+void test_unrolled_sort() {
+	using namespace rais::study;
+
+	std::minstd_rand randint{std::random_device{}()};
+	std::uniform_int_distribution mask;
+
+	linked_list<int> list;
+	unrolled_list<int> ulist;
+	for(int i = 0; i < 1000'0000; i++) {
+		int val = mask(randint);
+		list.push(val);
+		ulist.push(val);
+	}
+	std::cout << "length: " << ulist.size() << '\n';
+	auto seconds = [](auto start, auto end) {return std::chrono::duration<double>(end - start).count(); };
+
+	auto start = std::chrono::steady_clock::now();
+	long long sum = 0;
+	for(int i: list) sum += i;
+	auto end = std::chrono::steady_clock::now();
+	std::cout << "linked_list   traverse: " << seconds(start, end) << "s (" << sum % 10 << ")\n";
+
+	start = std::chrono::steady_clock::now();
+	sum = 0;
+	for(int i: ulist) sum += i;
+	end = std::chrono::steady_clock::now();
+	std::cout << "unrolled_list traverse: " << seconds(start, end) << "s (" << sum % 10 << ")\n";
+
+	start = std::chrono::steady_clock::now();
+	list.sort();
+	end = std::chrono::steady_clock::now();
+	std::cout << "linked_list   sort: " << seconds(start, end) << "s, " << std::boolalpha << list.is_sorted() << '\n';
+
+	start = std::chrono::steady_clock::now();
+	ulist.sort();
+	end = std::chrono::steady_clock::now();
+	std::cout << "unrolled_list sort: " << seconds(start, end) << "s, " << std::boolalpha << ulist.is_sorted() << '\n';
+}
+
+int main() {
+	test_unrolled_list_basic();
+	// test_unrolled_sort();
+}
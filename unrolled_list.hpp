@@ -0,0 +1,660 @@
+#pragma once
+
+//展开链表实现
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <concepts>
+#include <type_traits>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+
+namespace rais::study {
+
+using std::size_t;
+using std::byte;
+using std::move;
+using std::forward;
+using std::initializer_list;
+using std::allocator;
+using std::allocator_traits;
+using std::less;
+using std::less_equal;
+
+//concepts
+using std::same_as;
+using std::predicate;
+using std::convertible_to;
+
+template <typename T, size_t N>
+struct unrolled_node {
+
+	unrolled_node* next = nullptr;
+	size_t count = 0;                      //elements [0, count) are constructed
+	alignas(T) byte storage[N * sizeof(T)];
+
+	//user provided, so that the storage will not be zero initialized
+	unrolled_node() noexcept{}
+
+	//the unused storage, where the elements are constructed by placement new
+	T* raw() noexcept{return reinterpret_cast<T*>(storage); }
+	//the constructed elements, launder makes the pointer refer to them, count should not be 0
+	T* data() noexcept{return std::launder(raw()); }
+	const T* data() const noexcept{return std::launder(reinterpret_cast<const T*>(storage)); }
+	bool is_full() const noexcept{return count == N; }
+};
+
+
+/*
+ * 展开链表实现.
+ * - 每个节点最多存放N个元素, 节点内的元素连续存放在[0, count)
+ * - 链表为空时head == tail == nullptr, 否则每个节点至少存放一个元素
+ * - 插入时若节点已满, 则将节点对半分裂
+ * - 删除后若节点的元素少于N / 2, 且能与后继节点放进同一个节点, 则合并两个节点
+ * - 插入与删除会使迭代器失效
+ * - 元素的构造, 移动或比较抛出异常时链表仍然有效且不泄漏元素(基本保证), 但sort之后元素的顺序与被移动过的元素的值不确定
+ */
+template <typename T, size_t N = 64, typename AllocatorT = allocator<T>>
+class unrolled_list {
+
+	static_assert(N > 0, "a node should be able to hold at least one element");
+
+public:
+
+	using element_t = T;
+	using node_t = unrolled_node<T, N>;
+	using allocator_t = AllocatorT;
+	using node_allocator_t = typename allocator_traits<AllocatorT>::template rebind_alloc<node_t>;
+	using node_traits = allocator_traits<node_allocator_t>;
+	using value_traits = allocator_traits<AllocatorT>;
+
+	struct iterator {
+	private:
+		node_t* node;
+		size_t index;
+
+	public:
+		iterator(node_t* node, size_t index = 0): node{node}, index{index} {}
+		T& operator*() {return node->data()[index]; }
+		const T& operator*() const{ return node->data()[index]; }
+		T* operator->() noexcept{return node->data() + index; }
+		const T* operator->() const noexcept{return node->data() + index; }
+		iterator& operator++() {
+			if(++index == node->count) {
+				node = node->next;
+				index = 0;
+			}
+			return *this;
+		}
+		iterator operator++(int) {auto temp = *this; ++*this; return temp;}
+		bool operator==(const iterator& other) const noexcept{return node == other.node and index == other.index; }
+		bool operator!=(const iterator& other) const noexcept{return !(*this == other); }
+
+		node_t* get_ptr() noexcept{return node; }
+		const node_t* get_ptr() const noexcept{return node; }
+	};
+
+	struct const_iterator {
+	private:
+		const node_t* node;
+		size_t index;
+
+	public:
+		const_iterator(const node_t* node, size_t index = 0): node{node}, index{index} {}
+		const T& operator*() const{ return node->data()[index]; }
+		const T* operator->() const noexcept{return node->data() + index; }
+		const_iterator& operator++() {
+			if(++index == node->count) {
+				node = node->next;
+				index = 0;
+			}
+			return *this;
+		}
+		const_iterator operator++(int) {auto temp = *this; ++*this; return temp;}
+		bool operator==(const const_iterator& other) const noexcept{return node == other.node and index == other.index; }
+		bool operator!=(const const_iterator& other) const noexcept{return !(*this == other); }
+
+		const node_t* get_ptr() const noexcept{return node; }
+	};
+	using iterator_t = iterator;
+	using const_iterator_t = const_iterator;
+
+protected:
+
+	node_t* head = nullptr;
+	node_t* tail = nullptr; //the last node
+	size_t length = 0;
+	[[no_unique_address]] node_allocator_t alloc;
+
+public:
+
+	unrolled_list() {}
+	explicit unrolled_list(const AllocatorT& alloc): alloc(alloc) {}
+	unrolled_list(initializer_list<T> list, const AllocatorT& alloc = {}): alloc(alloc) {
+		push_or_clear(list.begin(), list.end());
+	}
+	~unrolled_list() {
+		clear();
+	}
+	unrolled_list(const unrolled_list& other): alloc(node_traits::select_on_container_copy_construction(other.alloc)) {
+		push_or_clear(other.begin(), other.end());
+	}
+	unrolled_list(unrolled_list&& other) noexcept: head{other.head}, tail{other.tail}, length{other.length}, alloc(move(other.alloc)) {
+		other.head = other.tail = nullptr;
+		other.length = 0;
+	}
+	unrolled_list& operator=(const unrolled_list& other) {
+		if(this == &other) return *this;
+		clear();
+		if constexpr(node_traits::propagate_on_container_copy_assignment::value) alloc = other.alloc;
+		for(const auto& i: other) push(i);
+		return *this;
+	}
+	unrolled_list& operator=(unrolled_list&& other) noexcept(node_traits::propagate_on_container_move_assignment::value or node_traits::is_always_equal::value) {
+		if(this == &other) return *this;
+		clear();
+		if constexpr(node_traits::propagate_on_container_move_assignment::value) {
+			alloc = move(other.alloc);
+		}else if(alloc != other.alloc) {
+			//the nodes of other can not be deallocated by alloc, move the elements one by one
+			for(auto& i: other) push(move(i));
+			other.clear();
+			return *this;
+		}
+		head = other.head;
+		tail = other.tail;
+		length = other.length;
+		other.head = other.tail = nullptr;
+		other.length = 0;
+		return *this;
+	}
+
+	size_t size() const noexcept{return length; }
+	size_t node_count() const noexcept{
+		size_t count = 0;
+		for(const node_t* pos = head; pos != nullptr; pos = pos->next) count++;
+		return count;
+	}
+
+	allocator_t get_allocator() const noexcept{return allocator_t(alloc); }
+
+	//no zero length check
+	T& front() {return head->data()[0]; }
+	const T& front() const{return head->data()[0]; }
+	T& back() {return tail->data()[tail->count - 1]; }
+	const T& back() const{return tail->data()[tail->count - 1]; }
+
+	iterator_t begin()              noexcept{return {head};    }
+	iterator_t end()                noexcept{return {nullptr}; }
+	const_iterator_t begin()  const noexcept{return {head};    }
+	const_iterator_t end()    const noexcept{return {nullptr}; }
+	const_iterator_t cbegin() const noexcept{return {head};    }
+	const_iterator_t cend()   const noexcept{return {nullptr}; }
+
+	bool is_empty() const noexcept{return !head; }
+
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	unrolled_list& push(U&& val) {
+		if(tail == nullptr or tail->is_full()) {
+			node_t* temp = new_node();
+			if(tail == nullptr) head = temp;
+			else tail->next = temp;
+			tail = temp;
+		}
+		construct_value(tail->raw() + tail->count, forward<U>(val));
+		tail->count++;
+		length++;
+		return *this;
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	unrolled_list& unshift(U&& val) {
+		if(head == nullptr or head->is_full()) {
+			node_t* temp = new_node();
+			temp->next = head;
+			head = temp;
+			if(tail == nullptr) tail = temp;
+		}
+		insert_into(head, 0, forward<U>(val));
+		return *this;
+	}
+
+	template <typename U>
+	requires convertible_to<U, const T&>
+	unrolled_list& insert(size_t index, U&& val) {
+		//the param index will be param val's new index of list,
+		//the previous element of the index will be shift to the next of the new element.
+		if(index >= length) return push(forward<U>(val));
+		auto [prev, node, offset] = locate(index);
+		if(node->is_full()) {
+			split(node);
+			if(offset > node->count) {
+				offset -= node->count;
+				node = node->next;
+			}
+		}
+		insert_into(node, offset, forward<U>(val));
+		return *this;
+	}
+
+	T& operator[](size_t index) {
+		//no boundary check
+		auto [prev, node, offset] = locate(index);
+		return node->data()[offset];
+	}
+
+	const T& operator[](size_t index) const{
+		//no boundary check
+		auto [prev, node, offset] = locate(index);
+		return node->data()[offset];
+	}
+
+	T* get_ptr(size_t index) {
+		if(index >= length) return nullptr;
+		return &(*this)[index];
+	}
+
+	const T* get_ptr(size_t index) const{
+		if(index >= length) return nullptr;
+		return &(*this)[index];
+	}
+
+	bool erase(size_t index) {
+		//returns whether erasing satisfied
+		if(index >= length) return false;
+		auto [prev, node, offset] = locate(index);
+		erase_from(node, offset);
+		if(node->count == 0) {
+			unlink(prev, node);
+		}else if(node->count < N / 2 and node->next != nullptr and node->count + node->next->count <= N) {
+			merge_next(node);
+		}
+		length--;
+		return true;
+	}
+
+	T shift() {
+		//no zero length check
+		T temp = move(front());
+		erase(0);
+		return temp;
+	}
+
+	T pop() {
+		//no zero length check
+		T temp = move(back());
+		erase(length - 1);
+		return temp;
+	}
+
+	void clear() {
+		node_t* pos = head;
+		while(pos != nullptr) {
+			node_t* temp = pos->next;
+			destroy_values(pos->data(), pos->count);
+			delete_node(pos);
+			pos = temp;
+		}
+		head = tail = nullptr;
+		length = 0;
+	}
+
+	void reverse() noexcept(std::is_nothrow_swappable_v<T>) {
+		if(length <= 1) return;
+		node_t* l = nullptr,
+		      * c = head;
+		tail = head;
+		while(c != nullptr) {
+			std::reverse(c->data(), c->data() + c->count);
+			node_t* r = c->next;
+			c->next = l;
+			l = c;
+			c = r;
+		}
+		head = l;
+	}
+
+	//sort inside every node, then merge the nodes bottom up.
+	//not stable, the result nodes are fully packed except the last one.
+	template <typename CompareT = less<T>>
+	requires predicate<CompareT, T, T>
+	void sort(const CompareT& comp = {}) {
+		if(length <= 1) return;
+
+		//bins[i] holds a sorted run of about 2^i nodes, like a binary counter.
+		//every node is in one of bins, carry, result, the unsorted nodes from pos or spare at any time
+		run bins[64] = {};
+		run carry = {},
+		    result = {};
+		node_t* spare = nullptr; //recycled nodes for merging
+		node_t* pos = head;
+		try {
+			while(pos != nullptr) {
+				std::sort(pos->data(), pos->data() + pos->count, comp);
+				carry = {pos, pos};
+				pos = pos->next;
+				carry.last->next = nullptr;
+
+				size_t i = 0;
+				for(; bins[i].first != nullptr; i++) {
+					//bins[i] is in front of carry
+					merge_runs(bins[i], carry, spare, comp);
+					carry = bins[i];
+					bins[i] = {};
+				}
+				bins[i] = carry;
+				carry = {};
+			}
+
+			for(auto& bin: bins) {
+				if(bin.first == nullptr) continue;
+				if(result.first != nullptr) merge_runs(bin, result, spare, comp);
+				result = bin;
+				bin = {};
+			}
+		}catch(...) {
+			//gather all the nodes in any order
+			result = join(result, carry);
+			for(auto& bin: bins) result = join(result, bin);
+			result = join(result, {pos, pos == nullptr ? nullptr : tail});
+			relink(result.first);
+			delete_nodes(spare);
+			throw;
+		}
+		head = result.first;
+		tail = result.last;
+		delete_nodes(spare);
+	}
+
+	template <typename CompareT = less_equal<T>> //where CompareT should be less_equal<T> to match sort(less<T>{})
+	requires predicate<CompareT, T, T>
+	bool is_sorted(const CompareT& comp = {}) const{
+		if(length <= 1) return true;
+		const T* prev = &front();
+		for(auto it = ++cbegin(); it != cend(); ++it) {
+			if( !comp(*prev, *it) ) return false;
+			prev = &*it;
+		}
+		return true;
+	}
+
+	friend void swap(unrolled_list& a, unrolled_list& b) noexcept{
+		if constexpr(node_traits::propagate_on_container_swap::value) {
+			using std::swap;
+			swap(a.alloc, b.alloc);
+		}
+		node_t* temp_head = a.head,
+		      * temp_tail = a.tail;
+		size_t temp_len = a.length;
+		a.head = b.head;
+		a.tail = b.tail;
+		a.length = b.length;
+		b.head = temp_head;
+		b.tail = temp_tail;
+		b.length = temp_len;
+	}
+
+	template <typename OutputStreamT> //such as std::ostream
+	requires requires(OutputStreamT& os, const T& val, char c, const char* s) {
+		{os << val}->same_as<OutputStreamT&>;
+		{os << c}->same_as<OutputStreamT&>;
+		{os << s}->same_as<OutputStreamT&>;
+	}
+	friend OutputStreamT& operator<<(OutputStreamT& os, const unrolled_list& list)  {
+		os << '[';
+		if(list.size() != 0) {
+			os << *list.cbegin();
+			for(auto it = ++list.cbegin(); it != list.cend(); ++it) {
+				os << ", " << *it;
+			}
+		}
+		return os << ']';
+	}
+
+protected:
+
+	struct position {
+		node_t* prev; //nullptr if node is head
+		node_t* node;
+		size_t offset;
+	};
+
+	struct run {
+		node_t* first;
+		node_t* last;
+	};
+
+	node_t* new_node() {
+		node_t* temp = node_traits::allocate(alloc, 1);
+		node_traits::construct(alloc, temp);
+		return temp;
+	}
+
+	void delete_node(node_t* node) noexcept{
+		//elements should be destroyed already
+		node_traits::destroy(alloc, node);
+		node_traits::deallocate(alloc, node, 1);
+	}
+
+	//the elements are constructed and destroyed by the allocator of the elements, as the other containers
+	template <typename... Args>
+	void construct_value(T* pos, Args&&... args) {
+		allocator_t value_alloc(alloc);
+		value_traits::construct(value_alloc, pos, forward<Args>(args)...);
+	}
+
+	void destroy_values(T* first, size_t n) noexcept{
+		allocator_t value_alloc(alloc);
+		for(size_t i = 0; i < n; i++) value_traits::destroy(value_alloc, first + i);
+	}
+
+	void move_values(T* first, size_t n, T* to) {
+		//to is uninitialized, [first, first + n) is destroyed after, nothing is changed if a move throws
+		size_t i = 0;
+		try {
+			for(; i < n; i++) construct_value(to + i, move(first[i]));
+		}catch(...) {
+			destroy_values(to, i);
+			throw;
+		}
+		destroy_values(first, n);
+	}
+
+	template <typename InputIteratorT>
+	void push_or_clear(InputIteratorT first, InputIteratorT last) {
+		//for the constructors, whose destructor is not called if they throw
+		try {
+			for(; first != last; ++first) push(*first);
+		}catch(...) {
+			clear();
+			throw;
+		}
+	}
+
+	void delete_nodes(node_t* pos) noexcept{
+		//the nodes from pos are empty
+		while(pos != nullptr) {
+			node_t* temp = pos->next;
+			delete_node(pos);
+			pos = temp;
+		}
+	}
+
+	position locate(size_t index) const noexcept{
+		//no boundary check
+		node_t* prev = nullptr,
+		      * pos = head;
+		while(index >= pos->count) {
+			index -= pos->count;
+			prev = pos;
+			pos = pos->next;
+		}
+		return {prev, pos, index};
+	}
+
+	template <typename U>
+	void insert_into(node_t* node, size_t offset, U&& val) {
+		//assume that node is not full, the length is increased.
+		//the new last element is counted once it's constructed, so that the others are kept if a move throws
+		if(offset == node->count) {
+			construct_value(node->raw() + offset, forward<U>(val));
+			node->count++;
+			length++;
+		}else {
+			//val might refer to an element of the node
+			T temp(forward<U>(val));
+			T* data = node->data();
+			construct_value(node->raw() + node->count, move(data[node->count - 1]));
+			node->count++;
+			length++;
+			std::move_backward(data + offset, data + node->count - 2, data + node->count - 1);
+			data[offset] = move(temp);
+		}
+	}
+
+	void erase_from(node_t* node, size_t offset) {
+		T* data = node->data();
+		std::move(data + offset + 1, data + node->count, data + offset);
+		node->count--;
+		destroy_values(data + node->count, 1);
+	}
+
+	void split(node_t* node) {
+		//move the upper half of node to a new node after it
+		node_t* temp = new_node();
+		size_t half = node->count / 2;
+		try {
+			move_values(node->data() + half, node->count - half, temp->raw());
+		}catch(...) {
+			delete_node(temp);
+			throw;
+		}
+		temp->count = node->count - half;
+		node->count = half;
+		temp->next = node->next;
+		node->next = temp;
+		if(node == tail) tail = temp;
+	}
+
+	void merge_next(node_t* node) {
+		//assume that node->count + node->next->count <= N
+		node_t* temp = node->next;
+		move_values(temp->data(), temp->count, node->raw() + node->count);
+		node->count += temp->count;
+		node->next = temp->next;
+		if(temp == tail) tail = node;
+		delete_node(temp);
+	}
+
+	void unlink(node_t* prev, node_t* node) noexcept{
+		//assume that node is empty
+		if(prev == nullptr) head = node->next;
+		else prev->next = node->next;
+		if(node == tail) tail = prev;
+		delete_node(node);
+	}
+
+	template <typename CompareT>
+	void merge_runs(run& a, run& b, node_t*& spare, const CompareT& comp) {
+		//a is in front of b, take from a when equal, the result is in a and b becomes empty.
+		//elements are moved into fully packed nodes, the consumed nodes are recycled into spare.
+		//if it throws, a holds all the nodes which are not recycled in any order, and b is still empty
+		run out = {nullptr, nullptr};
+		node_t* pa = a.first,
+		      * pb = b.first;
+		size_t ia = 0, ib = 0;
+
+		auto emit = [&](node_t*& from, size_t& index) {
+			if(out.last == nullptr or out.last->is_full()) {
+				node_t* temp = spare;
+				if(temp != nullptr) spare = spare->next;
+				else temp = new_node();
+				temp->next = nullptr;
+				temp->count = 0;
+				if(out.last == nullptr) out.first = temp;
+				else out.last->next = temp;
+				out.last = temp;
+			}
+			construct_value(out.last->raw() + out.last->count, move(from->data()[index]));
+			out.last->count++;
+			//the moved elements are destroyed with the node, so that there is no hole in a node
+			if(++index == from->count) {
+				node_t* consumed = from;
+				from = from->next;
+				index = 0;
+				destroy_values(consumed->data(), consumed->count);
+				consumed->count = 0;
+				consumed->next = spare;
+				spare = consumed;
+			}
+		};
+
+		try {
+			while(pa != nullptr and pb != nullptr) {
+				if( comp(pb->data()[ib], pa->data()[ia]) ) emit(pb, ib);
+				else emit(pa, ia);
+			}
+			while(pa != nullptr) emit(pa, ia);
+			while(pb != nullptr) emit(pb, ib);
+		}catch(...) {
+			drop_moved(pa, ia);
+			drop_moved(pb, ib);
+			a = join(join(out, {pa, pa == nullptr ? nullptr : a.last}), {pb, pb == nullptr ? nullptr : b.last});
+			b = {};
+			throw;
+		}
+		a = out;
+		b = {};
+	}
+
+	void drop_moved(node_t* node, size_t index) noexcept{
+		//the elements [0, index) of node are moved out, shift the rest to the front and destroy the moved ones at the back.
+		//if a move assignment throws, all the elements are kept
+		if(node == nullptr or index == 0) return;
+		T* data = node->data();
+		try {
+			std::move(data + index, data + node->count, data);
+		}catch(...) {
+			return;
+		}
+		destroy_values(data + node->count - index, index);
+		node->count -= index;
+	}
+
+	static run join(run a, run b) noexcept{
+		//link the run b after the run a
+		if(a.first == nullptr) return b;
+		if(b.first == nullptr) return a;
+		a.last->next = b.first;
+		return {a.first, b.last};
+	}
+
+	void relink(node_t* first) noexcept{
+		//the nodes from first become the list after sort() threw, the empty ones are deleted
+		head = tail = nullptr;
+		length = 0;
+		node_t** pos = &head;
+		while(first != nullptr) {
+			node_t* temp = first->next;
+			if(first->count == 0) {
+				delete_node(first);
+			}else {
+				*pos = first;
+				pos = &(first->next);
+				tail = first;
+				length += first->count;
+			}
+			first = temp;
+		}
+		*pos = nullptr;
+	}
+
+}; //class unrolled_list<T, N, AllocatorT>
+
+} //namespace rais::study